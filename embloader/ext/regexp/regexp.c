@@ -36,6 +36,7 @@ typedef struct Reclass Reclass;
 typedef struct Renode Renode;
 typedef struct Reinst Reinst;
 typedef struct Rethread Rethread;
+typedef struct Revm Revm;
 
 struct Reclass {
 	Rune *end;
@@ -45,7 +46,9 @@ struct Reclass {
 struct Reprog {
 	Reinst *start, *end;
 	int flags;
+	int backref;
 	unsigned int nsub;
+	Revm *vm;
 	Reclass cclass[16];
 };
 
@@ -68,9 +71,7 @@ static struct {
 
 static void die(const char *message)
 {
-	if(g.pstart) free(g.pstart);
-	if(g.prog) free(g.prog);
-	g.error = message;
+	if (!g.error) g.error = message;
 }
 
 static Rune canon(Rune c)
@@ -220,20 +221,28 @@ static int lexcount(void)
 	return L_COUNT;
 }
 
-static void newcclass(void)
+static int newcclass(void)
 {
-	if (g.ncclass >= nelem(g.prog->cclass))
+	if (g.ncclass >= nelem(g.prog->cclass)) {
 		die("too many character classes");
+		return -1;
+	}
 	g.yycc = g.prog->cclass + g.ncclass++;
 	g.yycc->end = g.yycc->spans;
+	return 0;
 }
 
 static void addrange(Rune a, Rune b)
 {
-	if (a > b)
+	if (g.error) return;
+	if (a > b) {
 		die("invalid character class range");
-	if (g.yycc->end + 2 == g.yycc->spans + nelem(g.yycc->spans))
+		return;
+	}
+	if (g.yycc->end + 2 >= g.yycc->spans + nelem(g.yycc->spans)) {
 		die("too many character class ranges");
+		return;
+	}
 	*g.yycc->end++ = a;
 	*g.yycc->end++ = b;
 }
@@ -293,7 +302,7 @@ static int lexclass(void)
 	int quoted, havesave, havedash;
 	Rune save = 0;
 
-	newcclass();
+	if (newcclass() == -1) return -1;
 
 	quoted = nextrune();
 	if (quoted == -1) return -1;
@@ -361,6 +370,7 @@ static int lexclass(void)
 			}
 		}
 
+		if (g.error) return -1;
 		quoted = nextrune();
 		if (quoted == -1) return -1;
 	}
@@ -371,6 +381,15 @@ static int lexclass(void)
 			addrange('-', '-');
 	}
 
+	if (g.error) return -1;
+	return type;
+}
+
+static int lexescclass(int type, void (*addranges)(void))
+{
+	if (newcclass() == -1) return -1;
+	addranges();
+	if (g.error) return -1;
 	return type;
 }
 
@@ -382,12 +401,12 @@ static int lex(void)
 		switch (g.yychar) {
 		case 'b': return L_WORD;
 		case 'B': return L_NWORD;
-		case 'd': newcclass(); addranges_d(); return L_CCLASS;
-		case 's': newcclass(); addranges_s(); return L_CCLASS;
-		case 'w': newcclass(); addranges_w(); return L_CCLASS;
-		case 'D': newcclass(); addranges_d(); return L_NCCLASS;
-		case 'S': newcclass(); addranges_s(); return L_NCCLASS;
-		case 'W': newcclass(); addranges_w(); return L_NCCLASS;
+		case 'd': return lexescclass(L_CCLASS, addranges_d);
+		case 's': return lexescclass(L_CCLASS, addranges_s);
+		case 'w': return lexescclass(L_CCLASS, addranges_w);
+		case 'D': return lexescclass(L_NCCLASS, addranges_d);
+		case 'S': return lexescclass(L_NCCLASS, addranges_s);
+		case 'W': return lexescclass(L_NCCLASS, addranges_w);
 		case '0': g.yychar = 0; return L_CHAR;
 		}
 		if (g.yychar >= '0' && g.yychar <= '9') {
@@ -491,20 +510,23 @@ static Renode *newrep(Renode *atom, int ng, int min, int max)
 	return rep;
 }
 
+/* once an error is recorded the lexer stops and every accept fails */
 static int next(void)
 {
+	if (g.error) return -1;
 	g.lookahead = lex();
-	if (g.lookahead == -1) return -1;
+	if (g.lookahead == -1 || g.error) {
+		die("syntax error");
+		g.lookahead = -1;
+		return -1;
+	}
 	return 0;
 }
 
 static int accept(int t)
 {
-	if (g.lookahead == t) {
-		if (next() == -1) return -1;
-		return 1;
-	}
-	return 0;
+	if (g.lookahead != t) return 0;
+	return next() == -1 ? 0 : 1;
 }
 
 static Renode *parsealt(void);
@@ -512,6 +534,7 @@ static Renode *parsealt(void);
 static Renode *parseatom(void)
 {
 	Renode *atom;
+	if (g.error) return NULL;
 	if (g.lookahead == L_CHAR) {
 		atom = newnode(P_CHAR);
 		atom->c = g.yychar;
@@ -551,6 +574,7 @@ static Renode *parseatom(void)
 		}
 		atom->n = g.nsub++;
 		atom->x = parsealt();
+		if (g.error) return NULL;
 		g.sub[atom->n] = atom;
 		if (!accept(')')) {
 			die("unmatched '('");
@@ -598,6 +622,7 @@ static Renode *parserep(void)
 	if (accept(L_NWORD)) return newnode(P_NWORD);
 
 	atom = parseatom();
+	if (!atom || g.error) return NULL;
 	if (g.lookahead == L_COUNT) {
 		int min = g.yymin, max = g.yymax;
 		if (next() == -1) return NULL;
@@ -638,11 +663,13 @@ static Renode *parsealt(void)
 {
 	Renode *alt, *x;
 	alt = parsecat();
+	if (g.error) return NULL;
 	while (accept('|')) {
 		x = alt;
 		alt = newnode(P_ALT);
 		alt->x = x;
 		alt->y = parsecat();
+		if (g.error) return NULL;
 	}
 	return alt;
 }
@@ -827,6 +854,7 @@ loop:
 	case P_REF:
 		inst = emit(prog, I_REF);
 		inst->n = node->n;
+		prog->backref = 1;
 		break;
 	}
 }
@@ -839,18 +867,21 @@ Reprog *regexp_comp(const char *pattern, int cflags, const char **errorp)
 
 	g.pstart = NULL;
 	g.prog = NULL;
+	g.error = NULL;
 
 	g.prog = malloc(sizeof (Reprog));
 	if (!g.prog) {
 		die("cannot allocate regular expression");
-		return NULL;
+		goto fail;
 	}
+	g.prog->start = NULL;
+	g.prog->vm = NULL;
 	n = strlen(pattern) * 2;
 	if (n > 0) {
 		g.pstart = g.pend = malloc(sizeof (Renode) * n);
 		if (!g.pstart) {
 			die("cannot allocate regular expression parse list");
-			return NULL;
+			goto fail;
 		}
 	}
 
@@ -861,31 +892,33 @@ Reprog *regexp_comp(const char *pattern, int cflags, const char **errorp)
 		g.sub[i] = 0;
 
 	g.prog->flags = cflags;
+	g.prog->backref = 0;
 
-	if (next() == -1) return NULL;
+	if (next() == -1) goto fail;
 	node = parsealt();
+	if (g.error) goto fail;
 	if (g.lookahead == ')') {
 		die("unmatched ')'");
-		return NULL;
+		goto fail;
 	}
 	if (g.lookahead != 0) {
 		die("syntax error");
-		return NULL;
+		goto fail;
 	}
 
 	v = count(node);
-	if (v == UINT_MAX) return NULL;
+	if (v == UINT_MAX) goto fail;
 	n = 6 + v;
 	if (n < 0 || n > MAXPROG) {
 		die("program too large");
-		return NULL;
+		goto fail;
 	}
 
 	g.prog->nsub = g.nsub;
 	g.prog->start = g.prog->end = malloc(n * sizeof (Reinst));
 	if (!g.prog->start){
 		die("cannot allocate regular expression program");
-		return NULL;
+		goto fail;
 	}
 
 	split = emit(g.prog, I_SPLIT);
@@ -903,22 +936,77 @@ Reprog *regexp_comp(const char *pattern, int cflags, const char **errorp)
 
 	if (errorp) *errorp = NULL;
 	return g.prog;
+
+fail:
+	if (g.pstart) free(g.pstart);
+	if (g.prog) regexp_free(g.prog);
+	if (errorp) *errorp = g.error;
+	return NULL;
 }
 
+static void vmfree(Revm *vm);
+
 void regexp_free(Reprog *prog)
 {
 	if (prog) {
+		if(prog->vm) vmfree(prog->vm);
 		if(prog->start) free(prog->start);
 		free(prog);
 	}
 }
 
+/* Program cache */
+
+#define CACHESIZE 16
+
+static struct {
+	char *pattern;
+	int flags;
+	Reprog *prog;
+	unsigned long used;
+} cache[CACHESIZE];
+
+static unsigned long cacheclock;
+
+static Reprog *cachecomp(const char *pattern, int flags, int *owned)
+{
+	Reprog *prog;
+	int i, slot = 0;
+	*owned = 0;
+	for (i = 0; i < CACHESIZE; ++i) {
+		if (cache[i].prog && cache[i].flags == flags &&
+			!strcmp(cache[i].pattern, pattern)) {
+			cache[i].used = ++cacheclock;
+			return cache[i].prog;
+		}
+		if (cache[i].used < cache[slot].used)
+			slot = i;
+	}
+	prog = regexp_comp(pattern, flags, NULL);
+	if (!prog) return NULL;
+	if (cache[slot].prog) {
+		regexp_free(cache[slot].prog);
+		free(cache[slot].pattern);
+		cache[slot].prog = NULL;
+	}
+	if (!(cache[slot].pattern = strdup(pattern))) {
+		cache[slot].used = 0;
+		*owned = 1;
+		return prog;
+	}
+	cache[slot].prog = prog;
+	cache[slot].flags = flags;
+	cache[slot].used = ++cacheclock;
+	return prog;
+}
+
 int regexp_match(const char *regex, const char *str, int flags) {
 	Reprog *prog;
-	prog = regexp_comp(regex, flags, NULL);
+	int ret, owned;
+	prog = cachecomp(regex, flags, &owned);
 	if (!prog) return 0;
-	int ret = regexp_exec(prog, str, NULL, 0);
-	regexp_free(prog);
+	ret = regexp_exec(prog, str, NULL, 0);
+	if (owned) regexp_free(prog);
 	return ret;
 }
 
@@ -1123,9 +1211,260 @@ static int match(Reinst *pc, const char *sp, const char *bol, int flags, Resub *
 	}
 }
 
+/* Pike VM: runs all threads in lock-step, O(length of string * size of program) */
+
+typedef struct Rejob Rejob;
+typedef struct Relist Relist;
+
+struct Rethread {
+	Reinst *pc;
+	const char **cap;
+};
+
+struct Relist {
+	Rethread *t;
+	const char **cap;
+	unsigned int n;
+};
+
+struct Rejob {
+	Reinst *pc;
+	unsigned int slot;
+	const char *sp;
+};
+
+struct Revm {
+	Reinst *start;
+	unsigned int ninst;
+	unsigned int ncap;
+	unsigned int gen;
+	unsigned int *mark;
+	const char **cap;
+	Rejob *stack;
+	Relist list[2];
+	Revm *la; /* lookahead sub-VM, one per nesting level */
+};
+
+static void vmfree(Revm *vm)
+{
+	int i;
+	if (!vm) return;
+	if (vm->la) vmfree(vm->la);
+	if (vm->mark) free(vm->mark);
+	if (vm->cap) free(vm->cap);
+	if (vm->stack) free(vm->stack);
+	for (i = 0; i < 2; ++i) {
+		if (vm->list[i].t) free(vm->list[i].t);
+		if (vm->list[i].cap) free(vm->list[i].cap);
+	}
+	free(vm);
+}
+
+static Revm *vmnew(Reprog *prog, unsigned int ncap)
+{
+	unsigned int n = prog->end - prog->start;
+	Revm *vm;
+	int i;
+	if (!(vm = malloc(sizeof (Revm))))
+		return NULL;
+	memset(vm, 0, sizeof (Revm));
+	vm->start = prog->start;
+	vm->ninst = n;
+	vm->ncap = ncap;
+	vm->mark = malloc(n * sizeof (unsigned int));
+	vm->cap = malloc((ncap + 1) * sizeof (const char *));
+	vm->stack = malloc((n + 1) * sizeof (Rejob));
+	if (!vm->mark || !vm->cap || !vm->stack)
+		goto fail;
+	memset(vm->mark, 0, n * sizeof (unsigned int));
+	for (i = 0; i < 2; ++i) {
+		vm->list[i].t = malloc(n * sizeof (Rethread));
+		vm->list[i].cap = malloc((n * ncap + 1) * sizeof (const char *));
+		if (!vm->list[i].t || !vm->list[i].cap)
+			goto fail;
+	}
+	return vm;
+fail:
+	vmfree(vm);
+	return NULL;
+}
+
+static void vmgen(Revm *vm)
+{
+	if (++vm->gen == 0) {
+		memset(vm->mark, 0, vm->ninst * sizeof (unsigned int));
+		vm->gen = 1;
+	}
+}
+
+static int assertion(Reinst *pc, const char *sp, const char *bol, int flags)
+{
+	int i;
+	switch (pc->opcode) {
+	case I_BOL:
+		if (sp == bol && !(flags & REG_NOTBOL))
+			return 1;
+		return (flags & REG_NEWLINE) && sp > bol && isnewline(sp[-1]);
+	case I_EOL:
+		if (*sp == 0)
+			return 1;
+		return (flags & REG_NEWLINE) && isnewline(*sp);
+	case I_WORD:
+	case I_NWORD:
+		i = sp > bol && iswordchar(sp[-1]);
+		i ^= iswordchar(sp[0]);
+		return pc->opcode == I_WORD ? i : !i;
+	}
+	return 0;
+}
+
+static int pikevm(Revm *vm, Reinst *pc, const char *sp, const char *bol, int flags, const char **out);
+
+/* run a lookahead on the sub-VM of this level, created once and kept with the program */
+static int lookahead(Revm *vm, Reinst *pc, const char *sp, const char *bol, int flags)
+{
+	Reprog sub;
+	if (!vm->la) {
+		sub.start = vm->start;
+		sub.end = vm->start + vm->ninst;
+		if (!(vm->la = vmnew(&sub, 0)))
+			return -1;
+	}
+	return pikevm(vm->la, pc, sp, bol, flags, NULL);
+}
+
+/* follow all empty transitions from pc in priority order and queue the threads reached */
+static void addthread(Revm *vm, Relist *l, Reinst *pc, const char **cap, const char *sp, const char *bol, int flags)
+{
+	Rejob *top = vm->stack;
+	Rethread *t;
+	unsigned int slot;
+	int ret;
+
+	if (cap) memcpy(vm->cap, cap, vm->ncap * sizeof (const char *));
+	else memset(vm->cap, 0, vm->ncap * sizeof (const char *));
+	top->pc = pc;
+	top++;
+	while (top > vm->stack) {
+		--top;
+		if (!top->pc) {
+			vm->cap[top->slot] = top->sp;
+			continue;
+		}
+		pc = top->pc;
+loop:
+		if (vm->mark[pc - vm->start] == vm->gen)
+			continue;
+		vm->mark[pc - vm->start] = vm->gen;
+		switch (pc->opcode) {
+		case I_JUMP:
+			pc = pc->x;
+			goto loop;
+		case I_SPLIT:
+			top->pc = pc->y;
+			top++;
+			pc = pc->x;
+			goto loop;
+		case I_LPAR:
+		case I_RPAR:
+			slot = pc->n * 2 + (pc->opcode == I_RPAR);
+			if (slot < vm->ncap) {
+				top->pc = NULL;
+				top->slot = slot;
+				top->sp = vm->cap[slot];
+				top++;
+				vm->cap[slot] = sp;
+			}
+			pc = pc + 1;
+			goto loop;
+		case I_BOL:
+		case I_EOL:
+		case I_WORD:
+		case I_NWORD:
+			if (!assertion(pc, sp, bol, flags))
+				continue;
+			pc = pc + 1;
+			goto loop;
+		case I_PLA:
+		case I_NLA:
+			ret = lookahead(vm, pc->x, sp, bol, flags);
+			if (ret < 0 || ret != (pc->opcode == I_PLA))
+				continue;
+			pc = pc->y;
+			goto loop;
+		default:
+			t = &l->t[l->n];
+			t->pc = pc;
+			t->cap = l->cap + l->n * vm->ncap;
+			memcpy(t->cap, vm->cap, vm->ncap * sizeof (const char *));
+			l->n++;
+		}
+	}
+}
+
+static int pikevm(Revm *vm, Reinst *pc, const char *sp, const char *bol, int flags, const char **out)
+{
+	Relist *clist = &vm->list[0], *nlist = &vm->list[1], *tmp;
+	Rethread *t;
+	unsigned int i;
+	int n, ok, matched = 0;
+	Rune c;
+
+	clist->n = 0;
+	vmgen(vm);
+	addthread(vm, clist, pc, NULL, sp, bol, flags);
+	while (clist->n > 0) {
+		n = chartorune(&c, sp);
+		nlist->n = 0;
+		vmgen(vm);
+		for (i = 0; i < clist->n; ++i) {
+			t = &clist->t[i];
+			switch (t->pc->opcode) {
+			case I_END:
+				/* threads after this one have lower priority */
+				matched = 1;
+				if (out) memcpy(out, t->cap, vm->ncap * sizeof (const char *));
+				i = clist->n;
+				continue;
+			case I_ANYNL:
+				ok = c != 0;
+				break;
+			case I_ANY:
+				ok = c != 0 && !isnewline(c);
+				break;
+			case I_CHAR:
+				ok = c != 0 && ((flags & REG_ICASE) ? canon(c) : c) == t->pc->c;
+				break;
+			case I_CCLASS:
+				ok = c != 0 && ((flags & REG_ICASE) ?
+					incclasscanon(t->pc->cc, canon(c)) :
+					incclass(t->pc->cc, c));
+				break;
+			case I_NCCLASS:
+				ok = c != 0 && !((flags & REG_ICASE) ?
+					incclasscanon(t->pc->cc, canon(c)) :
+					incclass(t->pc->cc, c));
+				break;
+			default:
+				ok = 0;
+			}
+			if (ok)
+				addthread(vm, nlist, t->pc + 1, t->cap, sp + n, bol, flags);
+		}
+		if (c == 0)
+			break;
+		sp += n;
+		tmp = clist;
+		clist = nlist;
+		nlist = tmp;
+	}
+	return matched;
+}
+
 int regexp_exec(Reprog *prog, const char *sp, Resub *sub, int eflags)
 {
 	Resub scratch;
+	const char *cap[MAXSUB * 2];
 	int i;
 
 	if (!sub)
@@ -1135,5 +1474,17 @@ int regexp_exec(Reprog *prog, const char *sp, Resub *sub, int eflags)
 	for (i = 0; i < MAXSUB; ++i)
 		sub->sub[i].sp = sub->sub[i].ep = NULL;
 
-	return !match(prog->start, sp, sp, prog->flags | eflags, sub);
+	/* back-references are not regular, keep backtracking for them */
+	if (!prog->vm && !prog->backref)
+		prog->vm = vmnew(prog, prog->nsub * 2);
+	if (!prog->vm)
+		return !match(prog->start, sp, sp, prog->flags | eflags, sub);
+
+	if (!pikevm(prog->vm, prog->start, sp, sp, prog->flags | eflags, cap))
+		return 1;
+	for (i = 0; i < (int) prog->nsub; ++i) {
+		sub->sub[i].sp = cap[i * 2];
+		sub->sub[i].ep = cap[i * 2 + 1];
+	}
+	return 0;
 }
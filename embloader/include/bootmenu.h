@@ -55,4 +55,6 @@ extern EFI_STATUS embloader_menu_start(embloader_loader **selected, uint64_t *fl
 extern EFI_STATUS embloader_show_menu();
 extern bool embloader_loader_is_reboot(embloader_loader *loader);
 extern bool embloader_loader_is_shutdown(embloader_loader *loader);
+extern void embloader_prefetch_start();
+extern void embloader_prefetch_discard(embloader_loader *keep);
 #endif
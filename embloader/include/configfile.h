@@ -16,6 +16,10 @@
 #include "list.h"
 
 typedef struct confignode confignode;
+typedef struct confignode_path confignode_path;
+
+/** Allocate the loaded tree from one arena, freed as a whole with the root */
+#define CONFIGFILE_LOAD_ARENA (1 << 0)
 
 /** Supported configuration file formats */
 typedef enum configfile_type {
@@ -53,15 +57,31 @@ typedef struct confignode_value {
 	size_t len;        ///< Length of the value
 } confignode_value;
 
+/**
+ * Callback filling children of a lazy MAP node on first access.
+ * key is the missing child, or NULL when every child is needed.
+ * Return true while more children can still be resolved later.
+ */
+typedef bool (*confignode_resolver)(confignode* node, const char* key, void* data);
+
 /** Iterator structure for traversing child nodes of MAP or ARRAY nodes */
 typedef struct confignode_iter {
-	void* cur;        ///< Internal iterator state (list position)
+	void* cur;        ///< Internal iterator state (list position of MAP)
 	confignode* root; ///< Root node being iterated over
 	confignode* node; ///< Current node in iteration (NULL when done)
 	const char *name; ///< Current key name (for MAP nodes)
 	int64_t index;    ///< Current index
 } confignode_iter;
 
+/** Maximum nesting depth of a confignode_builder */
+#define CONFIGNODE_BUILDER_DEPTH 16
+
+/** Cursor for filling a config tree without path lookups */
+typedef struct confignode_builder {
+	confignode* stack[CONFIGNODE_BUILDER_DEPTH]; ///< Entered nodes, stack[0] is the root
+	size_t depth;                                ///< Position of the current node
+} confignode_builder;
+
 // Configuration file I/O functions
 
 /** Load configuration from string buffer */
@@ -70,15 +90,34 @@ extern confignode* configfile_load_string(
 	const char* buff
 );
 
+/** Load configuration from string buffer with CONFIGFILE_LOAD_* flags */
+extern confignode* configfile_load_string_ex(
+	configfile_type type,
+	const char* buff,
+	uint32_t flags
+);
+
 /** Save configuration to string buffer (caller must free result) */
 extern char* configfile_save_string(configfile_type type, confignode* node);
 
 /** Load configuration from EFI file */
 extern confignode* configfile_load_efi_file(configfile_type type, EFI_FILE_PROTOCOL* file);
 
+/** Load configuration from EFI file with CONFIGFILE_LOAD_* flags */
+extern confignode* configfile_load_efi_file_ex(configfile_type type, EFI_FILE_PROTOCOL* file, uint32_t flags);
+
 /** Load configuration from EFI file at specified path */
 confignode* configfile_load_efi_file_path(configfile_type type, EFI_FILE_PROTOCOL* base, const char* path);
 
+/** Load configuration from EFI file at specified path with CONFIGFILE_LOAD_* flags */
+extern confignode* configfile_load_efi_file_path_ex(configfile_type type, EFI_FILE_PROTOCOL* base, const char* path, uint32_t flags);
+
+/** Serialize configuration tree into a binary image (caller must free result) */
+extern void* configfile_binary_save(confignode* node, size_t* len);
+
+/** Load configuration from a binary image with CONFIGFILE_LOAD_* flags */
+extern confignode* configfile_binary_load(const void* data, size_t len, uint32_t flags);
+
 /** Print configuration tree using custom print function */
 extern void confignode_print(confignode* node, int (*print)(const char*));
 
@@ -119,6 +158,13 @@ extern confignode* confignode_map_get(confignode* node, const char* key);
 /** Set/add child node with key in a MAP node */
 extern bool confignode_map_set(confignode* node, const char* key, confignode* sub);
 
+/** Fill children of MAP node lazily with resolver (NULL to remove) */
+extern bool confignode_map_set_resolver(
+	confignode* node,
+	confignode_resolver resolver,
+	void* data
+);
+
 // Array operations
 
 /** Get child node by index from an ARRAY node */
@@ -147,6 +193,9 @@ extern bool confignode_value_get(confignode* node, confignode_value* out);
 /** Get string representation of value (with default and success flag) */
 extern char* confignode_value_get_string(confignode* node, const char* def, bool* ok);
 
+/** Get borrowed string view of value, valid while the node lives (no allocation) */
+extern const char* confignode_value_get_cstr(confignode* node, const char* def, size_t* len);
+
 /** Get list of strings from VALUE node or ARRAY/MAP of VALUE nodes */
 extern list* confignode_value_get_string_or_list_to_list(confignode* node, bool* ok);
 
@@ -183,6 +232,9 @@ extern bool confignode_value_set_float(confignode* node, double f);
 /** Set boolean value (convenience function) */
 extern bool confignode_value_set_bool(confignode* node, bool b);
 
+/** Get counter changed by every config tree modification */
+extern uint64_t confignode_get_generation();
+
 // Node creation functions
 
 /** Create new NULL-type node */
@@ -223,14 +275,83 @@ extern confignode* confignode_copy(confignode* node);
 /** Merge source tree into target tree */
 extern bool confignode_merge(confignode* node, confignode* new);
 
+/** Merge by moving nodes out of new, new is always consumed */
+extern bool confignode_merge_steal(confignode* node, confignode* new);
+
 /** Replace node with new node (updates parent references) */
 extern bool confignode_replace(confignode** node, confignode* new);
 
+// Builder functions
+
+/** Start building at root node */
+extern void confignode_builder_init(confignode_builder* b, confignode* root);
+
+/** Get node children are added to */
+extern confignode* confignode_builder_current(confignode_builder* b);
+
+/** Enter MAP child by key (appended in ARRAY), pair with pop */
+extern confignode* confignode_builder_push_map(confignode_builder* b, const char* key);
+
+/** Enter ARRAY child by key (appended in ARRAY), pair with pop */
+extern confignode* confignode_builder_push_array(confignode_builder* b, const char* key);
+
+/** Enter nested MAP children by dotted path, reset to leave */
+extern confignode* confignode_builder_push_path(confignode_builder* b, const char* path);
+
+/** Go back to parent node */
+extern void confignode_builder_pop(confignode_builder* b);
+
+/** Go back to root node */
+extern void confignode_builder_reset(confignode_builder* b);
+
+/** Add child node to current node (takes ownership) */
+extern bool confignode_builder_set(confignode_builder* b, const char* key, confignode* sub);
+
+/** Add value child to current node */
+extern bool confignode_builder_set_value(
+	confignode_builder* b,
+	const char* key,
+	const confignode_value* value
+);
+
+/** Add string child to current node */
+extern bool confignode_builder_set_string(
+	confignode_builder* b,
+	const char* key,
+	const char* s
+);
+
+/** Add formatted string child to current node */
+extern bool confignode_builder_set_string_fmt(
+	confignode_builder* b,
+	const char* key,
+	const char* fmt,
+	...
+);
+
+/** Add integer child to current node */
+extern bool confignode_builder_set_int(confignode_builder* b, const char* key, int64_t i);
+
+/** Add float child to current node */
+extern bool confignode_builder_set_float(confignode_builder* b, const char* key, double f);
+
+/** Add boolean child to current node */
+extern bool confignode_builder_set_bool(confignode_builder* b, const char* key, bool v);
+
 // Path-based access functions
 
 /** Look up node by path string (e.g. "root.array[0].value") */
 extern confignode* confignode_path_lookup(confignode* node, const char* path, bool create);
 
+/** Compile path string into a reusable handle (free with confignode_path_free) */
+extern confignode_path* confignode_path_compile(const char* path);
+
+/** Free a compiled path handle */
+extern void confignode_path_free(confignode_path* path);
+
+/** Look up node by compiled path, cached until any tree is modified */
+extern confignode* confignode_path_resolve(confignode* node, confignode_path* path);
+
 /** Get path string for node location in tree */
 extern bool confignode_path_get(confignode* node, char* buff, size_t size);
 
@@ -280,6 +401,14 @@ extern char* confignode_path_get_string(
 	bool* ok
 );
 
+/** Get borrowed string view at path, valid while the node lives (no allocation) */
+extern const char* confignode_path_get_cstr(
+	confignode* node,
+	const char* path,
+	const char* def,
+	size_t* len
+);
+
 /** Get list of strings from VALUE node or ARRAY/MAP of VALUE nodes at path */
 extern list* confignode_path_get_string_or_list_to_list(
 	confignode* node,
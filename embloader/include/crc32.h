@@ -0,0 +1,7 @@
+#ifndef CRC32_H
+#define CRC32_H
+#include <stdint.h>
+#include <stddef.h>
+extern uint32_t s_crc32(void* buffer, size_t length);
+extern uint32_t s_crc32_update(uint32_t crc, const void* buffer, size_t length);
+#endif
@@ -12,6 +12,7 @@ enum ansi_state {
 	STATE_ESC = 1,
 	STATE_CSI = 2,
 };
+typedef bool (*efi_idle_handler)(void *data);
 extern EFI_HANDLE efi_get_parent_device(EFI_HANDLE handle);
 extern EFI_LOADED_IMAGE_PROTOCOL* efi_get_loaded_image(void);
 extern EFI_HANDLE efi_get_current_device(void);
@@ -45,6 +46,8 @@ extern EFI_DEVICE_PATH_PROTOCOL* efi_device_path_append_filepath(
 	EFI_DEVICE_PATH_PROTOCOL *dp,
 	const char *path
 );
+extern void efi_set_idle_handler(efi_idle_handler handler, void *data);
+extern UINTN efi_idle_stall(UINTN usec);
 extern bool efi_is_setup_supported();
 extern EFI_STATUS efi_reboot_to_setup();
 #endif
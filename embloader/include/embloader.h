@@ -22,6 +22,7 @@ struct embloader {
 	char *ktype;
 	char *device_name;
 	list *profiles;
+	uint32_t smbios_crc;
 	fdt fdt;
 	embloader_menu *menu;
 	sdboot_menu *sdboot;
@@ -31,6 +32,9 @@ extern embloader g_embloader;
 extern void find_embloader_folder(embloader_dir *dir);
 extern bool embloader_init();
 extern bool embloader_load_configs();
+extern bool embloader_config_cache_load();
+extern void embloader_config_cache_save();
+extern bool embloader_config_checksum(uint32_t *crc);
 extern bool embloader_load_config_one(const char *name);
 extern bool embloader_load_smbios();
 extern bool embloader_try_match(confignode *node);
@@ -53,4 +57,10 @@ extern EFI_STATUS embloader_start_efi(
 	void *img, size_t len,
 	const char *cmdline
 );
+extern EFI_STATUS embloader_start_efi_ex(
+	EFI_DEVICE_PATH_PROTOCOL *dp,
+	void *img, size_t len,
+	const char *cmdline,
+	bool free_img
+);
 #endif
@@ -6,12 +6,59 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+typedef void (*efi_file_read_cb)(const void* buffer, size_t len, void* data);
 extern EFI_STATUS efi_file_get_info_by(EFI_FILE_PROTOCOL* file, EFI_GUID *guid, VOID** info, UINTN *info_size);
 extern EFI_STATUS efi_file_get_info(EFI_FILE_PROTOCOL* file, EFI_FILE_INFO** info);
 extern EFI_STATUS efi_get_fs_info(EFI_SIMPLE_FILE_SYSTEM_PROTOCOL* fs, EFI_FILE_SYSTEM_INFO** info);
 extern EFI_STATUS efi_file_get_size(EFI_FILE_PROTOCOL* file, size_t* size);
 extern EFI_STATUS efi_file_set_size(EFI_FILE_PROTOCOL* file, size_t size);
 extern EFI_STATUS efi_file_chunked_read(EFI_FILE_PROTOCOL* file, size_t offset, void* buffer, size_t size);
+extern EFI_STATUS efi_file_read_chunks(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	size_t chunk,
+	efi_file_read_cb cb,
+	void* data
+);
+extern EFI_STATUS efi_file_read_chunks_async(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	size_t chunk,
+	efi_file_read_cb cb,
+	void* data
+);
+extern EFI_STATUS efi_file_tune_chunk(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	efi_file_read_cb cb,
+	void* data,
+	size_t* chunk,
+	size_t* probed
+);
+extern void efi_file_tune_setup(bool enabled, bool persist);
+extern EFI_STATUS efi_file_chunked_read_ex(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	efi_file_read_cb cb,
+	void* data
+);
+extern EFI_STATUS efi_file_stream_read(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	size_t size,
+	void* scratch,
+	size_t scratch_size,
+	efi_file_read_cb cb,
+	void* data
+);
 extern EFI_STATUS efi_file_read_all(EFI_FILE_PROTOCOL* file, void** out, size_t *flen);
 extern EFI_STATUS efi_file_read_pages(EFI_FILE_PROTOCOL* file, void** out, size_t *flen);
 extern bool efi_file_write_all(EFI_FILE_PROTOCOL* file, const void* data, size_t len);
@@ -5,16 +5,26 @@
 typedef struct linux_data linux_data;
 typedef struct linux_bootinfo linux_bootinfo;
 typedef struct linux_overlay linux_overlay;
+typedef struct linux_initramfs_file linux_initramfs_file;
+typedef struct linux_prefetch linux_prefetch;
 
 struct linux_overlay {
 	char *path;
 	confignode *params;
 };
 
+struct linux_initramfs_file {
+	char *name;
+	EFI_FILE_PROTOCOL *file;
+	size_t size;
+};
+
 struct linux_bootinfo {
 	EFI_FILE_PROTOCOL *root;
 	char *kernel;
+	bool kernel_direct;
 	list *initramfs;
+	bool initramfs_stream;
 	list *bootargs;
 	char *bootargs_override;
 	char *devicetree;
@@ -23,8 +33,10 @@ struct linux_bootinfo {
 
 struct linux_data {
 	void *kernel;
+	char *kernel_path;
 	size_t kernel_size;
 	void *initramfs;
+	list *initramfs_files;
 	size_t initramfs_size;
 	fdt fdt;
 	char *bootargs;
@@ -49,16 +61,28 @@ extern int linux_load_dtbos(EFI_FILE_PROTOCOL *base, fdt fdt, list *alt_dir, enu
 extern bool linux_dtbo_write_overrides(fdt fdt, confignode *overrides);
 extern char* linux_prepare_bootargs(list *def_bootargs);
 extern char* linux_bootinfo_prepare_bootargs(linux_bootinfo *info);
+extern bool linux_kernel_is_direct(linux_bootinfo *info);
 extern EFI_STATUS linux_load_kernel(linux_data *data, linux_bootinfo *info);
 extern EFI_STATUS linux_load_initramfs(linux_data *data, linux_bootinfo *info);
 extern EFI_STATUS linux_load_bootargs(linux_data *data, linux_bootinfo *info);
 extern EFI_STATUS linux_load_devicetree(linux_data *data, linux_bootinfo *info);
 extern EFI_STATUS linux_load_dtoverlay(linux_data *data, linux_bootinfo *info);
+extern EFI_STATUS linux_initramfs_open(linux_bootinfo *info, list **files, size_t *total);
+extern EFI_STATUS linux_initramfs_alloc(size_t size, void **pages);
 extern EFI_STATUS linux_initramfs_register(const void *ptr, size_t size, EFI_HANDLE *hand);
+extern EFI_STATUS linux_initramfs_register_files(list *files, size_t size, EFI_HANDLE *hand);
 extern EFI_STATUS linux_initramfs_unregister(EFI_HANDLE hand);
+extern void linux_initramfs_files_free(list *files);
 extern EFI_STATUS linux_boot_efi(void *img, size_t len, const char *cmdline);
+extern EFI_STATUS linux_boot_efi_staged(void *img, size_t len, const char *cmdline);
+extern EFI_STATUS linux_boot_efi_path(const char *path, const char *cmdline);
 extern EFI_STATUS linux_boot_use_efi(linux_data *data);
 extern linux_data* linux_data_load(linux_bootinfo *info);
+extern EFI_STATUS linux_data_finish(linux_data *data, linux_bootinfo *info);
 extern void linux_data_clean(linux_data *data);
+extern linux_prefetch* linux_prefetch_new(linux_bootinfo *info);
+extern EFI_STATUS linux_prefetch_step(linux_prefetch *pf, size_t slice);
+extern linux_data* linux_prefetch_finish(linux_prefetch *pf);
+extern void linux_prefetch_free(linux_prefetch *pf);
 extern EFI_STATUS linux_install_fdt(fdt fdt);
 #endif
@@ -10,6 +10,7 @@ typedef enum log_level {
 } log_level;
 
 extern void log_init();
+extern void log_sync();
 extern void log_base_print(
 	log_level level, 
 	const char *tag,
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdarg.h>
+extern const EFI_GUID efivar_embloader_guid;
 extern EFI_STATUS efivar_set_raw(
 	const EFI_GUID *vendor,
 	const char *name,
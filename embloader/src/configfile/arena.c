@@ -0,0 +1,294 @@
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <inttypes.h>
+#include "internal.h"
+#include "log.h"
+
+#define ARENA_BLOCK_SIZE SIZE_64KB
+#define ARENA_ALIGN sizeof(uint64_t)
+
+typedef struct arena_block arena_block;
+
+struct arena_block {
+	arena_block* next;
+	size_t pages;
+	size_t used;
+	size_t size;
+};
+
+struct confignode_arena {
+	arena_block* blocks;
+	size_t refs;
+	size_t foreign;
+	size_t allocs;
+	size_t bytes;
+	size_t count;
+};
+
+static confignode_arena* current_arena = NULL;
+
+size_t confignode_heap_allocs = 0;
+
+/**
+ * @brief Create a new empty arena for config nodes.
+ * The caller holds one reference, dropped with confignode_arena_put.
+ *
+ * @return a new arena, or NULL on allocation failure
+ *
+ */
+confignode_arena* confignode_arena_new(void) {
+	confignode_arena* arena = malloc(sizeof(confignode_arena));
+	if (!arena) return NULL;
+	memset(arena, 0, sizeof(confignode_arena));
+	arena->refs = 1;
+	return arena;
+}
+
+/**
+ * @brief Take a reference of an arena.
+ *
+ * @param arena the arena to reference (may be NULL)
+ * @return the arena
+ *
+ */
+confignode_arena* confignode_arena_get(confignode_arena* arena) {
+	if (arena) arena->refs++;
+	return arena;
+}
+
+/**
+ * @brief Drop a reference of an arena, free it when none is left.
+ *
+ * @param arena the arena to release (may be NULL)
+ *
+ */
+void confignode_arena_put(confignode_arena* arena) {
+	if (!arena) return;
+	if (arena->refs > 0 && --arena->refs > 0) return;
+	log_debug(
+		"release config arena with %" PRIu64 " allocations in %" PRIu64 " blocks",
+		(uint64_t) arena->allocs, (uint64_t) arena->count
+	);
+	confignode_arena_free(arena);
+}
+
+/**
+ * @brief Select the arena used by confignode_new.
+ * Nodes created while an arena is selected, and everything they own, are
+ * allocated from that arena.
+ *
+ * @param arena the arena to use, or NULL to allocate from heap
+ * @return the previously selected arena
+ *
+ */
+confignode_arena* confignode_arena_use(confignode_arena* arena) {
+	confignode_arena* old = current_arena;
+	current_arena = arena;
+	return old;
+}
+
+/**
+ * @brief Get the arena selected by confignode_arena_use.
+ *
+ * @return the current arena, or NULL if allocating from heap
+ *
+ */
+confignode_arena* confignode_arena_current(void) {
+	return current_arena;
+}
+
+/**
+ * @brief Get the allocation counters of an arena.
+ *
+ * @param arena the arena to query
+ * @param allocs receive the number of allocations (may be NULL)
+ * @param blocks receive the number of page blocks (may be NULL)
+ * @param bytes receive the number of bytes handed out (may be NULL)
+ *
+ */
+void confignode_arena_stat(
+	confignode_arena* arena,
+	size_t* allocs,
+	size_t* blocks,
+	size_t* bytes
+) {
+	if (allocs) *allocs = arena ? arena->allocs : 0;
+	if (blocks) *blocks = arena ? arena->count : 0;
+	if (bytes) *bytes = arena ? arena->bytes : 0;
+}
+
+/**
+ * @brief Free an arena and all memory allocated from it.
+ *
+ * @param arena the arena to free (may be NULL)
+ *
+ */
+void confignode_arena_free(confignode_arena* arena) {
+	arena_block *b, *next;
+	if (!arena) return;
+	if (current_arena == arena) current_arena = NULL;
+	for (b = arena->blocks; b; b = next) {
+		next = b->next;
+		FreePages(b, b->pages);
+	}
+	memset(arena, 0, sizeof(confignode_arena));
+	free(arena);
+}
+
+static void* arena_alloc(confignode_arena* arena, size_t size) {
+	arena_block* b = arena->blocks;
+	size = ALIGN_VALUE(size, ARENA_ALIGN);
+	if (!b || b->size - b->used < size) {
+		size_t len = sizeof(arena_block) + size;
+		if (len < ARENA_BLOCK_SIZE) len = ARENA_BLOCK_SIZE;
+		size_t pages = EFI_SIZE_TO_PAGES(len);
+		if (!(b = AllocatePages(pages))) return NULL;
+		b->pages = pages;
+		b->size = EFI_PAGES_TO_SIZE(pages);
+		b->used = ALIGN_VALUE(sizeof(arena_block), ARENA_ALIGN);
+		if (arena->blocks && size > ARENA_BLOCK_SIZE / 4) {
+			b->next = arena->blocks->next;
+			arena->blocks->next = b;
+		} else {
+			b->next = arena->blocks;
+			arena->blocks = b;
+		}
+		arena->count++;
+	}
+	void* ptr = (uint8_t*) b + b->used;
+	b->used += size;
+	arena->allocs++;
+	arena->bytes += size;
+	return ptr;
+}
+
+/**
+ * @brief Allocate memory for a config node or data owned by it.
+ *
+ * @param arena the owning arena, or NULL to allocate from heap
+ * @param size the number of bytes to allocate
+ * @return pointer to allocated memory, or NULL on allocation failure
+ *
+ */
+void* confignode_alloc(confignode_arena* arena, size_t size) {
+	if (arena) return arena_alloc(arena, size);
+	confignode_heap_allocs++;
+	return malloc(size);
+}
+
+/**
+ * @brief Free memory returned by confignode_alloc.
+ * Memory from an arena is only released with the whole arena.
+ *
+ * @param arena the owning arena, or NULL if allocated from heap
+ * @param ptr the memory to free (may be NULL)
+ *
+ */
+void confignode_free(confignode_arena* arena, void* ptr) {
+	if (!arena && ptr) free(ptr);
+}
+
+/**
+ * @brief Resize memory returned by confignode_alloc.
+ *
+ * @param arena the owning arena, or NULL if allocated from heap
+ * @param ptr the memory to resize (may be NULL)
+ * @param old the current size of the memory
+ * @param size the new size of the memory
+ * @return pointer to resized memory, or NULL on allocation failure
+ *
+ */
+void* confignode_realloc(confignode_arena* arena, void* ptr, size_t old, size_t size) {
+	if (!arena) {
+		confignode_heap_allocs++;
+		return realloc(ptr, size);
+	}
+	void* ret = arena_alloc(arena, size);
+	if (ret && ptr) memcpy(ret, ptr, MIN(old, size));
+	return ret;
+}
+
+/**
+ * @brief Duplicate a string into memory owned by a config node.
+ *
+ * @param arena the owning arena, or NULL to allocate from heap
+ * @param str the string to duplicate
+ * @return the duplicated string, or NULL on allocation failure
+ *
+ */
+char* confignode_strdup(confignode_arena* arena, const char* str) {
+	if (!str) return NULL;
+	size_t len = strlen(str) + 1;
+	char* ret = confignode_alloc(arena, len);
+	if (ret) memcpy(ret, str, len);
+	return ret;
+}
+
+/**
+ * @brief Account a child node being attached to a parent node.
+ * An arena stays alive while any of its nodes is not owned by another node
+ * of the same arena, and remembers how many outside nodes it holds.
+ *
+ * @param parent the new parent node
+ * @param sub the child node being attached
+ *
+ */
+void confignode_arena_attach(confignode* parent, confignode* sub) {
+	if (sub->arena && sub->arena == parent->arena) sub->arena->refs--;
+	else if (parent->arena) parent->arena->foreign++;
+}
+
+/**
+ * @brief Account a child node being detached from its parent node.
+ *
+ * @param parent the old parent node
+ * @param sub the child node being detached
+ *
+ */
+void confignode_arena_detach(confignode* parent, confignode* sub) {
+	if (sub->arena && sub->arena == parent->arena) sub->arena->refs++;
+	else if (parent->arena) parent->arena->foreign--;
+}
+
+static void arena_release_foreign(confignode_arena* arena, confignode* node) {
+	list *p, *n;
+	if (node->type == CONFIGNODE_TYPE_ARRAY) {
+		for (size_t i = 0; i < node->array.len && arena->foreign > 0; i++) {
+			confignode* sub = node->array.data[i];
+			if (sub->arena == arena) {
+				arena_release_foreign(arena, sub);
+				continue;
+			}
+			sub->parent = NULL;
+			arena->foreign--;
+			confignode_clean(sub);
+		}
+	} else if (node->type == CONFIGNODE_TYPE_MAP) {
+		if ((p = list_first(node->items))) do {
+			n = p->next;
+			LIST_DATA_DECLARE(sub, p, confignode*);
+			if (!sub || sub->parent != node) continue;
+			if (sub->arena == arena) {
+				arena_release_foreign(arena, sub);
+				continue;
+			}
+			sub->parent = NULL;
+			arena->foreign--;
+			confignode_clean(sub);
+		} while ((p = n) && arena->foreign > 0);
+	}
+}
+
+/**
+ * @brief Release a detached arena node and its children.
+ * Outside nodes attached below it are cleaned normally, arena memory is
+ * freed in whole blocks once no node of the arena is referenced anymore.
+ *
+ * @param node the arena node to release, must not have a parent
+ *
+ */
+void confignode_arena_release(confignode* node) {
+	confignode_arena* arena = node->arena;
+	if (arena->foreign > 0) arena_release_foreign(arena, node);
+	confignode_arena_put(arena);
+}
@@ -11,14 +11,8 @@
  */
 confignode* confignode_array_get(confignode* node, size_t index) {
 	if (!node || node->type != CONFIGNODE_TYPE_ARRAY) return NULL;
-	list* p;
-	if ((p = list_first(node->items))) do {
-			LIST_DATA_DECLARE(n, p, confignode*);
-			if (!n || n->parent != node || n->index != index)
-				continue;
-			return n;
-		} while ((p = p->next));
-	return NULL;
+	if (index >= node->array.len) return NULL;
+	return node->array.data[index];
 }
 
 /**
@@ -30,8 +24,7 @@ confignode* confignode_array_get(confignode* node, size_t index) {
  */
 size_t confignode_array_len(confignode* node) {
 	if (!node || node->type != CONFIGNODE_TYPE_ARRAY) return 0;
-	ssize_t ret = list_count(node->items);
-	return ret > 0 ? (size_t) ret : 0;
+	return node->array.len;
 }
 
 /**
@@ -48,6 +41,27 @@ confignode* confignode_new_array() {
 	return n;
 }
 
+static bool array_reserve(confignode* node, size_t len) {
+	confignode** data;
+	size_t size = node->array.size ? node->array.size : 8;
+	if (len <= node->array.size) return true;
+	while (size < len) size *= 2;
+	data = confignode_realloc(
+		node->arena, node->array.data,
+		sizeof(confignode*) * node->array.size,
+		sizeof(confignode*) * size
+	);
+	if (!data) return false;
+	node->array.data = data;
+	node->array.size = size;
+	return true;
+}
+
+static void array_renumber(confignode* node, size_t from) {
+	for (size_t i = from; i < node->array.len; i++)
+		node->array.data[i]->index = i;
+}
+
 /**
  * @brief Append a child node to the end of an array-type config node.
  *
@@ -59,10 +73,12 @@ confignode* confignode_new_array() {
 bool confignode_array_append(confignode* node, confignode* sub) {
 	if (!node || !sub || sub->parent) return false;
 	if (node->type != CONFIGNODE_TYPE_ARRAY) return false;
-	int st = list_obj_add_new(&node->items, sub);
-	if (st != 0) return false;
+	if (!array_reserve(node, node->array.len + 1)) return false;
+	confignode_generation++;
+	sub->index = node->array.len;
+	node->array.data[node->array.len++] = sub;
 	sub->parent = node;
-	configfile_array_fixup(node);
+	confignode_arena_attach(node, sub);
 	return true;
 }
 
@@ -76,13 +92,33 @@ bool confignode_array_append(confignode* node, confignode* sub) {
  */
 void configfile_array_fixup(confignode* node) {
 	if (!node || node->type != CONFIGNODE_TYPE_ARRAY) return;
-	size_t index = 0;
-	list* p;
-	if ((p = list_first(node->items))) do {
-		LIST_DATA_DECLARE(n, p, confignode*);
-		if (!n || n->parent != node) continue;
-		n->index = index++;
-	} while ((p = p->next));
+	array_renumber(node, 0);
+}
+
+/**
+ * @brief Remove a child node from an array-type config node.
+ * Following elements are moved down and renumbered, the child node itself
+ * is not freed.
+ *
+ * @param node the array-type node to remove from
+ * @param sub the child node to remove
+ *
+ */
+void confignode_array_remove(confignode* node, confignode* sub) {
+	size_t i = 0;
+	if (
+		sub->index >= 0 && (size_t) sub->index < node->array.len &&
+		node->array.data[sub->index] == sub
+	) i = sub->index;
+	else while (i < node->array.len && node->array.data[i] != sub) i++;
+	if (i >= node->array.len) return;
+	confignode_generation++;
+	memmove(
+		&node->array.data[i], &node->array.data[i + 1],
+		sizeof(confignode*) * (node->array.len - i - 1)
+	);
+	node->array.len--;
+	array_renumber(node, i);
 }
 
 /**
@@ -97,18 +133,18 @@ void configfile_array_fixup(confignode* node) {
 bool confignode_array_insert(confignode* node, size_t index, confignode* sub) {
 	if (!node || !sub || sub->parent) return false;
 	if (node->type != CONFIGNODE_TYPE_ARRAY) return false;
-	list* p;
-	int status = -1;
-	if (index == 0) status = list_obj_insert_new(&node->items, sub);
-	else if ((p = list_first(node->items))) do {
-		LIST_DATA_DECLARE(n, p, confignode*);
-		if (!n || n->parent != node || n->index != index) continue;
-		status = list_insert_new(p, sub);
-		break;
-	} while ((p = p->next));
-	if (status != 0) return false;
+	if (index != 0 && index >= node->array.len) return false;
+	if (!array_reserve(node, node->array.len + 1)) return false;
+	confignode_generation++;
+	memmove(
+		&node->array.data[index + 1], &node->array.data[index],
+		sizeof(confignode*) * (node->array.len - index)
+	);
+	node->array.data[index] = sub;
+	node->array.len++;
 	sub->parent = node;
-	configfile_array_fixup(node);
+	confignode_arena_attach(node, sub);
+	array_renumber(node, index);
 	return true;
 }
 
@@ -123,14 +159,15 @@ bool confignode_array_insert(confignode* node, size_t index, confignode* sub) {
  */
 bool confignode_array_extend(confignode* node, size_t nlen) {
 	if (!node || node->type != CONFIGNODE_TYPE_ARRAY) return false;
-	size_t len = confignode_array_len(node);
-	while (nlen > len) {
-		for (size_t i = len; i < nlen; i++)
-			if (!confignode_array_append(node, confignode_new()))
-				return false;
-		len = confignode_array_len(node);
+	if (!array_reserve(node, nlen)) return false;
+	while (node->array.len < nlen) {
+		confignode* n = confignode_new();
+		if (!n) return false;
+		if (!confignode_array_append(node, n)) {
+			confignode_clean(n);
+			return false;
+		}
 	}
-	configfile_array_fixup(node);
 	return true;
 }
 
@@ -0,0 +1,234 @@
+#include "internal.h"
+#include "crc32.h"
+
+#define BINARY_MAGIC 0x47464345 /* "ECFG" */
+#define BINARY_VERSION 1
+#define BINARY_MAX_DEPTH 256
+#define BINARY_NO_KEY UINT32_MAX
+
+struct binary_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t nodes;
+	uint32_t strings;
+	uint32_t crc;
+	uint32_t reserved;
+};
+
+struct binary_node {
+	uint8_t type;
+	uint8_t vtype;
+	uint16_t reserved;
+	uint32_t key;
+	uint32_t count;
+	uint32_t reserved2;
+	uint64_t value;
+};
+
+struct binary_ctx {
+	struct binary_node* nodes;
+	char* pool;
+	size_t node_cnt;
+	size_t pool_len;
+	size_t node_pos;
+	size_t pool_pos;
+};
+
+static void binary_measure(confignode* node, struct binary_ctx* ctx, bool map) {
+	ctx->node_cnt++;
+	if (map && node->key) ctx->pool_len += strlen(node->key) + 1;
+	if (
+		node->type == CONFIGNODE_TYPE_VALUE &&
+		node->value.type == VALUE_STRING && node->value.v.s
+	) ctx->pool_len += strlen(node->value.v.s) + 1;
+	if (
+		node->type == CONFIGNODE_TYPE_MAP ||
+		node->type == CONFIGNODE_TYPE_ARRAY
+	) confignode_foreach(iter, node) binary_measure(
+		iter.node, ctx, node->type == CONFIGNODE_TYPE_MAP
+	);
+}
+
+static uint32_t binary_add_string(struct binary_ctx* ctx, const char* str) {
+	size_t len = strlen(str) + 1;
+	uint32_t off = ctx->pool_pos;
+	memcpy(ctx->pool + off, str, len);
+	ctx->pool_pos += len;
+	return off;
+}
+
+static void binary_fill(confignode* node, struct binary_ctx* ctx, bool map) {
+	struct binary_node* bn = &ctx->nodes[ctx->node_pos++];
+	memset(bn, 0, sizeof(struct binary_node));
+	bn->type = node->type;
+	bn->key = map && node->key ?
+		binary_add_string(ctx, node->key) : BINARY_NO_KEY;
+	switch (node->type) {
+		case CONFIGNODE_TYPE_VALUE:
+			bn->vtype = node->value.type;
+			switch (node->value.type) {
+				case VALUE_STRING:
+					if (node->value.v.s)
+						bn->value = binary_add_string(ctx, node->value.v.s);
+					else bn->value = BINARY_NO_KEY;
+					break;
+				case VALUE_INT:
+					memcpy(&bn->value, &node->value.v.i, sizeof(int64_t));
+					break;
+				case VALUE_FLOAT:
+					memcpy(&bn->value, &node->value.v.f, sizeof(double));
+					break;
+				case VALUE_BOOL:
+					bn->value = node->value.v.b;
+					break;
+			}
+			break;
+		case CONFIGNODE_TYPE_MAP:
+		case CONFIGNODE_TYPE_ARRAY:
+			confignode_foreach(iter, node) {
+				binary_fill(iter.node, ctx, node->type == CONFIGNODE_TYPE_MAP);
+				bn->count++;
+			}
+			break;
+		default:;
+	}
+}
+
+/**
+ * @brief Serialize a confignode tree into a compact binary image.
+ * The image is a flat pre-order node table followed by a string pool, and
+ * can be loaded back with configfile_binary_load without any text parsing.
+ *
+ * @param node the confignode tree to serialize
+ * @param len pointer to receive the image size
+ * @return newly allocated image that must be freed by caller, or NULL on
+ * failure
+ *
+ */
+void* configfile_binary_save(confignode* node, size_t* len) {
+	struct binary_ctx ctx;
+	struct binary_header* hdr;
+	if (!node || !len) return NULL;
+	memset(&ctx, 0, sizeof(ctx));
+	binary_measure(node, &ctx, false);
+	if (ctx.node_cnt > UINT32_MAX || ctx.pool_len >= UINT32_MAX) return NULL;
+	size_t nodes_size = sizeof(struct binary_node) * ctx.node_cnt;
+	size_t size = sizeof(struct binary_header) + nodes_size + ctx.pool_len;
+	if (!(hdr = malloc(size))) return NULL;
+	memset(hdr, 0, sizeof(struct binary_header));
+	ctx.nodes = (struct binary_node*) (hdr + 1);
+	ctx.pool = (char*) ctx.nodes + nodes_size;
+	binary_fill(node, &ctx, false);
+	hdr->magic = BINARY_MAGIC;
+	hdr->version = BINARY_VERSION;
+	hdr->nodes = ctx.node_cnt;
+	hdr->strings = ctx.pool_len;
+	hdr->crc = s_crc32(ctx.nodes, nodes_size + ctx.pool_len);
+	*len = size;
+	return hdr;
+}
+
+static const char* binary_string(struct binary_ctx* ctx, uint64_t off) {
+	if (off >= ctx->pool_len) return NULL;
+	return ctx->pool + off;
+}
+
+static confignode* binary_load_node(struct binary_ctx* ctx, int depth) {
+	confignode* node = NULL;
+	confignode_value value;
+	if (depth > BINARY_MAX_DEPTH || ctx->node_pos >= ctx->node_cnt) return NULL;
+	struct binary_node* bn = &ctx->nodes[ctx->node_pos++];
+	switch (bn->type) {
+		case CONFIGNODE_TYPE_NULL:
+			return confignode_new();
+		case CONFIGNODE_TYPE_VALUE:
+			memset(&value, 0, sizeof(value));
+			value.type = bn->vtype;
+			switch (bn->vtype) {
+				case VALUE_STRING:
+					value.v.s = (char*) binary_string(ctx, bn->value);
+					if (!value.v.s) return NULL;
+					break;
+				case VALUE_INT:
+					memcpy(&value.v.i, &bn->value, sizeof(int64_t));
+					break;
+				case VALUE_FLOAT:
+					memcpy(&value.v.f, &bn->value, sizeof(double));
+					break;
+				case VALUE_BOOL:
+					value.v.b = bn->value != 0;
+					break;
+				default:
+					return NULL;
+			}
+			return confignode_new_value(&value);
+		case CONFIGNODE_TYPE_MAP:
+			node = confignode_new_map();
+			break;
+		case CONFIGNODE_TYPE_ARRAY:
+			node = confignode_new_array();
+			break;
+		default:
+			return NULL;
+	}
+	if (!node) return NULL;
+	for (uint32_t i = 0; i < bn->count; i++) {
+		uint32_t key = ctx->node_pos < ctx->node_cnt ?
+			ctx->nodes[ctx->node_pos].key : BINARY_NO_KEY;
+		confignode* sub = binary_load_node(ctx, depth + 1);
+		if (!sub) goto fail;
+		bool ok;
+		if (node->type == CONFIGNODE_TYPE_MAP) {
+			const char* name = binary_string(ctx, key);
+			ok = name && confignode_set_key(sub, name) &&
+				confignode_map_append(node, sub);
+		} else ok = confignode_array_append(node, sub);
+		if (!ok) {
+			confignode_clean(sub);
+			goto fail;
+		}
+	}
+	return node;
+fail:
+	confignode_clean(node);
+	return NULL;
+}
+
+/**
+ * @brief Load a confignode tree from a binary image.
+ * The image is verified with its checksum before any node is created.
+ *
+ * @param data the binary image from configfile_binary_save
+ * @param len the image size
+ * @param flags CONFIGFILE_LOAD_* flags
+ * @return newly allocated confignode tree, or NULL on invalid image or
+ * allocation failure
+ *
+ */
+confignode* configfile_binary_load(const void* data, size_t len, uint32_t flags) {
+	const struct binary_header* hdr = data;
+	struct binary_ctx ctx;
+	confignode_arena *arena = NULL, *old;
+	if (!data || len < sizeof(struct binary_header)) return NULL;
+	if (hdr->magic != BINARY_MAGIC || hdr->version != BINARY_VERSION) return NULL;
+	size_t nodes_size = sizeof(struct binary_node) * (size_t) hdr->nodes;
+	if (len != sizeof(struct binary_header) + nodes_size + hdr->strings) return NULL;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.nodes = (struct binary_node*) (hdr + 1);
+	ctx.pool = (char*) ctx.nodes + nodes_size;
+	ctx.node_cnt = hdr->nodes;
+	ctx.pool_len = hdr->strings;
+	if (ctx.pool_len > 0 && ctx.pool[ctx.pool_len - 1] != 0) return NULL;
+	if (s_crc32(ctx.nodes, nodes_size + ctx.pool_len) != hdr->crc) return NULL;
+	if ((flags & CONFIGFILE_LOAD_ARENA) && !(arena = confignode_arena_new()))
+		return NULL;
+	old = confignode_arena_use(arena);
+	confignode* node = binary_load_node(&ctx, 0);
+	confignode_arena_use(old);
+	confignode_arena_put(arena);
+	if (node && ctx.node_pos != ctx.node_cnt) {
+		confignode_clean(node);
+		node = NULL;
+	}
+	return node;
+}
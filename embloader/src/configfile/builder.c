@@ -0,0 +1,271 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include "internal.h"
+
+/**
+ * @brief Start building a config tree at the specified node.
+ * The builder keeps a cursor on the node children are added to, so
+ * generated trees are filled without any path lookups.
+ *
+ * @param b the builder to initialize
+ * @param root the MAP or ARRAY node to start building at
+ *
+ */
+void confignode_builder_init(confignode_builder* b, confignode* root) {
+	if (!b) return;
+	memset(b, 0, sizeof(confignode_builder));
+	b->stack[0] = root;
+}
+
+/**
+ * @brief Get the node the builder currently adds children to.
+ *
+ * @param b the builder
+ * @return the current node, or NULL if the last push failed
+ *
+ */
+confignode* confignode_builder_current(confignode_builder* b) {
+	if (!b || b->depth >= CONFIGNODE_BUILDER_DEPTH) return NULL;
+	return b->stack[b->depth];
+}
+
+static bool builder_put(confignode_builder* b, const char* key, confignode* sub) {
+	confignode* cur = confignode_builder_current(b);
+	bool ret = false;
+	if (!sub) return false;
+	if (cur && cur->type == CONFIGNODE_TYPE_ARRAY) {
+		ret = confignode_array_append(cur, sub);
+	} else if (cur && cur->type == CONFIGNODE_TYPE_MAP && key) {
+		if (confignode_map_get(cur, key))
+			ret = confignode_map_set(cur, key, sub);
+		else ret = confignode_set_key(sub, key) &&
+			confignode_map_append(cur, sub);
+	}
+	if (!ret) confignode_clean(sub);
+	return ret;
+}
+
+static confignode* builder_push(
+	confignode_builder* b,
+	const char* key,
+	confignode_type type
+) {
+	confignode *cur, *sub = NULL;
+	if (!b) return NULL;
+	cur = confignode_builder_current(b);
+	if (cur && cur->type == CONFIGNODE_TYPE_MAP && key)
+		sub = confignode_map_get(cur, key);
+	if (cur && (!sub || sub->type != type)) {
+		sub = type == CONFIGNODE_TYPE_MAP ?
+			confignode_new_map() : confignode_new_array();
+		if (!builder_put(b, key, sub)) sub = NULL;
+	}
+	if (++b->depth < CONFIGNODE_BUILDER_DEPTH) b->stack[b->depth] = sub;
+	else sub = NULL;
+	return sub;
+}
+
+/**
+ * @brief Enter a MAP child of the current node.
+ * In a MAP node the child with the specified key is reused if it is a MAP
+ * already, otherwise a new MAP replaces it. In an ARRAY node a new MAP is
+ * appended. Every push must be paired with confignode_builder_pop, even if
+ * it failed.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @return the entered node, or NULL on failure
+ *
+ */
+confignode* confignode_builder_push_map(confignode_builder* b, const char* key) {
+	return builder_push(b, key, CONFIGNODE_TYPE_MAP);
+}
+
+/**
+ * @brief Enter an ARRAY child of the current node.
+ * Same as confignode_builder_push_map but for ARRAY nodes.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @return the entered node, or NULL on failure
+ *
+ */
+confignode* confignode_builder_push_array(confignode_builder* b, const char* key) {
+	return builder_push(b, key, CONFIGNODE_TYPE_ARRAY);
+}
+
+/**
+ * @brief Enter nested MAP children by a dotted path (e.g. "menu.style").
+ * Array indices are not supported, use confignode_path_lookup for those.
+ *
+ * @param b the builder
+ * @param path the dotted path relative to the current node
+ * @return the entered node, or NULL on failure
+ *
+ */
+confignode* confignode_builder_push_path(confignode_builder* b, const char* path) {
+	char buff[64], *key;
+	confignode* ret = confignode_builder_current(b);
+	if (!b || !path) return NULL;
+	while (*path) {
+		size_t len = strcspn(path, ".");
+		if (!(key = len < sizeof(buff) ? buff : malloc(len + 1))) {
+			ret = NULL;
+			break;
+		}
+		memcpy(key, path, len);
+		key[len] = 0;
+		ret = confignode_builder_push_map(b, key);
+		if (key != buff) free(key);
+		if (!ret) break;
+		path += len;
+		if (*path == '.') path++;
+	}
+	return ret;
+}
+
+/**
+ * @brief Leave the current node and go back to its parent.
+ *
+ * @param b the builder
+ *
+ */
+void confignode_builder_pop(confignode_builder* b) {
+	if (b && b->depth > 0) b->depth--;
+}
+
+/**
+ * @brief Leave all entered nodes and go back to the root.
+ *
+ * @param b the builder
+ *
+ */
+void confignode_builder_reset(confignode_builder* b) {
+	if (b) b->depth = 0;
+}
+
+/**
+ * @brief Add a node as child of the current node.
+ * In a MAP node an existing child with the same key is replaced, in an
+ * ARRAY node the child is appended. The builder takes ownership of sub
+ * in any case.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @param sub the node to add
+ * @return true on success, false on failure
+ *
+ */
+bool confignode_builder_set(confignode_builder* b, const char* key, confignode* sub) {
+	if (!b) {
+		confignode_clean(sub);
+		return false;
+	}
+	return builder_put(b, key, sub);
+}
+
+/**
+ * @brief Add a value child to the current node.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @param value the value to set (strings are copied)
+ * @return true on success, false on failure
+ *
+ */
+bool confignode_builder_set_value(
+	confignode_builder* b,
+	const char* key,
+	const confignode_value* value
+) {
+	if (!b || !value) return false;
+	return builder_put(b, key, confignode_new_value(value));
+}
+
+/**
+ * @brief Add a string value child to the current node.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @param s the string value to set
+ * @return true on success, false on failure
+ *
+ */
+bool confignode_builder_set_string(
+	confignode_builder* b,
+	const char* key,
+	const char* s
+) {
+	if (!b || !s) return false;
+	return builder_put(b, key, confignode_new_string(s));
+}
+
+/**
+ * @brief Add a formatted string value child to the current node.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @param fmt the printf-style format string
+ * @param ... additional arguments for formatting
+ * @return true on success, false on failure
+ *
+ */
+bool confignode_builder_set_string_fmt(
+	confignode_builder* b,
+	const char* key,
+	const char* fmt,
+	...
+) {
+	if (!b || !fmt) return false;
+	char* buf = NULL;
+	va_list va;
+	va_start(va, fmt);
+	int len = vasprintf(&buf, fmt, va);
+	va_end(va);
+	if (len < 0 || !buf) return false;
+	bool res = confignode_builder_set_string(b, key, buf);
+	free(buf);
+	return res;
+}
+
+/**
+ * @brief Add an integer value child to the current node.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @param i the integer value to set
+ * @return true on success, false on failure
+ *
+ */
+bool confignode_builder_set_int(confignode_builder* b, const char* key, int64_t i) {
+	if (!b) return false;
+	return builder_put(b, key, confignode_new_int(i));
+}
+
+/**
+ * @brief Add a floating point value child to the current node.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @param f the double value to set
+ * @return true on success, false on failure
+ *
+ */
+bool confignode_builder_set_float(confignode_builder* b, const char* key, double f) {
+	if (!b) return false;
+	return builder_put(b, key, confignode_new_float(f));
+}
+
+/**
+ * @brief Add a boolean value child to the current node.
+ *
+ * @param b the builder
+ * @param key the key of the child (ignored for ARRAY nodes)
+ * @param v the boolean value to set
+ * @return true on success, false on failure
+ *
+ */
+bool confignode_builder_set_bool(confignode_builder* b, const char* key, bool v) {
+	if (!b) return false;
+	return builder_put(b, key, confignode_new_bool(v));
+}
@@ -6,7 +6,7 @@
 #include "str-utils.h"
 #include "log.h"
 
-static bool conf_parse_value(const char* valstr, confignode_value* value) {
+static bool conf_parse_value(char* valstr, confignode_value* value) {
 	if (!valstr || !value) return false;
 	char* end = NULL;
 	int64_t ival = strtoll(valstr, &end, 0);
@@ -35,14 +35,52 @@ static bool conf_parse_value(const char* valstr, confignode_value* value) {
 		return true;
 	}
 	value->type = VALUE_STRING;
-	value->v.s = strdup(valstr);
-	if (!value->v.s) return false;
+	value->v.s = valstr;
 	value->len = strlen(valstr);
 	return true;
 }
 
-static bool conf_parse_line(confignode* node, const char* line, size_t len) {
-	if (!node || !line || len == 0) return false;
+struct conf_parser {
+	confignode* root;
+	confignode_builder builder;
+	const char* prefix;
+	size_t prefix_len;
+};
+
+static bool conf_set_value(
+	struct conf_parser* ctx,
+	const char* key,
+	char* keystr,
+	const confignode_value* value
+) {
+	const char* leaf = strrchr(keystr, '.');
+	size_t plen = leaf ? (size_t) (leaf - keystr) : 0;
+	if (!strchr(keystr, '[')) {
+		if (
+			!ctx->prefix || ctx->prefix_len != plen ||
+			memcmp(ctx->prefix, key, plen) != 0
+		) {
+			confignode_builder_reset(&ctx->builder);
+			ctx->prefix = key, ctx->prefix_len = plen;
+			if (leaf) {
+				keystr[plen] = 0;
+				if (!confignode_builder_push_path(&ctx->builder, keystr))
+					ctx->prefix = NULL;
+				keystr[plen] = '.';
+			}
+		}
+		if (ctx->prefix) return confignode_builder_set_value(
+			&ctx->builder, leaf ? leaf + 1 : keystr, value
+		);
+	}
+	/* array indices may replace any entered node, start over after them */
+	confignode_builder_reset(&ctx->builder);
+	ctx->prefix = NULL;
+	return confignode_path_set_value(ctx->root, keystr, value);
+}
+
+static bool conf_parse_line(struct conf_parser* ctx, const char* line, size_t len) {
+	if (!ctx || !line || len == 0) return false;
 	while (len > 0 && isspace(line[len - 1])) len--;
 	while (len > 0 && isspace(*line)) line++, len--;
 	if (len == 0 || *line == '#') return true;
@@ -64,12 +102,8 @@ static bool conf_parse_line(confignode* node, const char* line, size_t len) {
 		return false;
 	}
 	confignode_value value = {0};
-	if (!conf_parse_value(valstr, &value)) {
-		free(keystr);
-		free(valstr);
-		return false;
-	}
-	bool result = confignode_path_set_value(node, keystr, &value);
+	bool result = conf_parse_value(valstr, &value) &&
+		conf_set_value(ctx, key, keystr, &value);
 	free(keystr);
 	free(valstr);
 	return result;
@@ -79,28 +113,32 @@ static bool conf_parse_line(confignode* node, const char* line, size_t len) {
  * @brief Parse configuration from string buffer in conf format.
  * Supports key-value pairs with nested paths and array indices.
  * Example: "menu.timeout = 30" or "test.array[0].val = value"
+ * Consecutive lines under the same section reuse the builder cursor
+ * instead of walking the path from the root again.
  *
  * @param buff string buffer containing configuration data
  * @return newly created root config node, or NULL on error
  */
 confignode* configfile_conf_load_string(const char* buff) {
+	struct conf_parser ctx;
 	if (!buff) return NULL;
-	confignode* root = confignode_new_map();
-	if (!root) return NULL;
+	memset(&ctx, 0, sizeof(ctx));
+	if (!(ctx.root = confignode_new_map())) return NULL;
+	confignode_builder_init(&ctx.builder, ctx.root);
 	int lineno = 0;
 	const char* line_start = buff, * cur = buff;
 	while (*cur) {
 		lineno++;
 		while (*cur && *cur != '\n' && *cur != '\r') cur++;
 		size_t line_len = cur - line_start;
-		if (line_len > 0 && !conf_parse_line(root, line_start, line_len)) {
+		if (line_len > 0 && !conf_parse_line(&ctx, line_start, line_len)) {
 			log_warning("failed to parse config line %d", lineno);
 			log_debug("line %d: '%.*s'", lineno, (int)line_len, line_start);
 		}
 		while (*cur == '\n' || *cur == '\r') cur++;
 		line_start = cur;
 	}
-	return root;
+	return ctx.root;
 }
 
 static bool conf_append_string(char** result, size_t* size, size_t* pos, const char* str) {
@@ -154,6 +192,7 @@ static bool conf_save_node_recursive(confignode* node, const char* prefix, char*
 	}
 	if (type == CONFIGNODE_TYPE_MAP) {
 		list* p;
+		confignode_map_resolve(node, NULL);
 		if ((p = list_first(node->items))) do {
 			LIST_DATA_DECLARE(child, p, confignode*);
 			if (!child || !child->key) continue;
@@ -177,10 +216,8 @@ static bool conf_save_node_recursive(confignode* node, const char* prefix, char*
 		return true;
 	}
 	if (type == CONFIGNODE_TYPE_ARRAY) {
-		list* p;
-		if ((p = list_first(node->items))) do {
-			LIST_DATA_DECLARE(child, p, confignode*);
-			if (!child) continue;
+		for (size_t i = 0; i < node->array.len; i++) {
+			confignode* child = node->array.data[i];
 			char* new_prefix;
 			size_t prefix_len = prefix ? strlen(prefix) : 0;
 			new_prefix = malloc(prefix_len + 20);
@@ -190,7 +227,7 @@ static bool conf_save_node_recursive(confignode* node, const char* prefix, char*
 			bool result_ok = conf_save_node_recursive(child, new_prefix, result, size, pos);
 			free(new_prefix);
 			if (!result_ok) return false;
-		} while ((p = p->next));
+		}
 		return true;
 	}
 	return true;
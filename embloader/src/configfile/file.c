@@ -2,7 +2,9 @@
 #include "internal.h"
 #include "file-utils.h"
 #include "efi-utils.h"
+#include "ticks.h"
 #include "log.h"
+#include <inttypes.h>
 
 /**
  * @brief Load a confignode tree from a string buffer in the specified format.
@@ -27,6 +29,47 @@ confignode* configfile_load_string(configfile_type type, const char* buff) {
 	return NULL;
 }
 
+/**
+ * @brief Load a confignode tree from a string buffer with load flags.
+ * With CONFIGFILE_LOAD_ARENA the whole tree is allocated from page sized
+ * blocks of one arena instead of one heap allocation per node and string,
+ * cleaning the root node then frees all blocks at once. Nodes of an arena
+ * tree can still be moved to or copied into other trees.
+ *
+ * @param type the format type of the configuration data
+ * @param buff the configuration data as a null-terminated string
+ * @param flags CONFIGFILE_LOAD_* flags
+ * @return newly allocated confignode tree, or NULL on parse error, unsupported
+ * format, or allocation failure
+ *
+ */
+confignode* configfile_load_string_ex(
+	configfile_type type,
+	const char* buff,
+	uint32_t flags
+) {
+	confignode_arena *arena = NULL, *old;
+	size_t heap = confignode_heap_allocs, allocs = 0, blocks = 0;
+	if ((flags & CONFIGFILE_LOAD_ARENA) && !(arena = confignode_arena_new()))
+		return NULL;
+	old = confignode_arena_use(arena);
+	confignode* node = configfile_load_string(type, buff);
+	confignode_arena_use(old);
+	heap = confignode_heap_allocs - heap;
+	confignode_arena_stat(arena, &allocs, &blocks, NULL);
+	if (node && arena) log_debug(
+		"config tree loaded with %" PRIu64 " arena allocations "
+		"in %" PRIu64 " blocks and %" PRIu64 " heap allocations",
+		(uint64_t) allocs, (uint64_t) blocks, (uint64_t) heap
+	);
+	else if (node) log_debug(
+		"config tree loaded with %" PRIu64 " heap allocations",
+		(uint64_t) heap
+	);
+	confignode_arena_put(arena);
+	return node;
+}
+
 /**
  * @brief Save a confignode tree to a string buffer in the specified format.
  * This function dispatches to the appropriate format-specific serializer based
@@ -91,11 +134,30 @@ void confignode_print(confignode* node, int (*print)(const char*)) {
  *
  */
 confignode* configfile_load_efi_file(configfile_type type, EFI_FILE_PROTOCOL* file) {
+	return configfile_load_efi_file_ex(type, file, 0);
+}
+
+/**
+ * @brief Load a confignode tree from an EFI file with load flags.
+ *
+ * @param type the format type of the configuration file
+ * @param file pointer to an opened EFI_FILE_PROTOCOL for reading
+ * @param flags CONFIGFILE_LOAD_* flags
+ * @return newly allocated confignode tree, or NULL on failure
+ *
+ * @see configfile_load_string_ex() for the meaning of flags
+ *
+ */
+confignode* configfile_load_efi_file_ex(
+	configfile_type type,
+	EFI_FILE_PROTOCOL* file,
+	uint32_t flags
+) {
 	if (!file) return NULL;
 	char* data = NULL;
 	EFI_STATUS status = efi_file_read_all(file, (void**)&data, NULL);
 	if (EFI_ERROR(status) || !data) return NULL;
-	confignode* node = configfile_load_string(type, data);
+	confignode* node = configfile_load_string_ex(type, data, flags);
 	free(data);
 	return node;
 }
@@ -122,6 +184,28 @@ confignode* configfile_load_efi_file_path(
 	configfile_type type,
 	EFI_FILE_PROTOCOL* base,
 	const char* path
+) {
+	return configfile_load_efi_file_path_ex(type, base, path, 0);
+}
+
+/**
+ * @brief Load a confignode tree from an EFI file at a path with load flags.
+ *
+ * @param type the format type of the configuration file
+ * @param base pointer to an opened EFI_FILE_PROTOCOL representing the base
+ * directory
+ * @param path the relative path to the configuration file
+ * @param flags CONFIGFILE_LOAD_* flags
+ * @return newly allocated confignode tree, or NULL on failure
+ *
+ * @see configfile_load_string_ex() for the meaning of flags
+ *
+ */
+confignode* configfile_load_efi_file_path_ex(
+	configfile_type type,
+	EFI_FILE_PROTOCOL* base,
+	const char* path,
+	uint32_t flags
 ) {
 	if (!base || !path) return NULL;
 	EFI_FILE_PROTOCOL* file;
@@ -136,8 +220,14 @@ confignode* configfile_load_efi_file_path(
 		);
 		return NULL;
 	}
-	confignode* node = configfile_load_efi_file(type, file);
+	uint64_t start = ticks_usec();
+	confignode* node = configfile_load_efi_file_ex(type, file, flags);
 	file->Close(file);
+	uint64_t used = ticks_usec() - start;
+	if (node && start > 0) log_debug(
+		"parsed config file %s in %" PRIu64 "us",
+		path, used
+	);
 	return node;
 }
 
@@ -6,6 +6,17 @@
 #include "json.h"
 #include "yaml.h"
 
+typedef struct confignode_hash confignode_hash;
+typedef struct confignode_arena confignode_arena;
+
+struct confignode_hash {
+	size_t size;
+	size_t used;
+	size_t filled;
+	list** slots;
+	list* tail;
+};
+
 struct configfile {
 	configfile_type type;
 	confignode* root;
@@ -13,15 +24,49 @@ struct configfile {
 
 struct confignode {
 	confignode* parent;
+	confignode_arena* arena;
 	char* key;
+	uint32_t keyhash;
 	ssize_t index;
 	confignode_type type;
 	list* items;
+	confignode_hash* hash;
+	struct {
+		confignode** data;
+		size_t len;
+		size_t size;
+	} array;
 	confignode_value value;
+	char* text;
+	confignode_resolver resolver;
+	void* resolver_data;
 };
 
+extern size_t confignode_heap_allocs;
+extern uint64_t confignode_generation;
+extern confignode* confignode_map_get_hash(confignode* node, const char* key, uint32_t hash);
+extern confignode_arena* confignode_arena_new(void);
+extern confignode_arena* confignode_arena_get(confignode_arena* arena);
+extern void confignode_arena_put(confignode_arena* arena);
+extern confignode_arena* confignode_arena_use(confignode_arena* arena);
+extern confignode_arena* confignode_arena_current(void);
+extern void confignode_arena_stat(confignode_arena* arena, size_t* allocs, size_t* blocks, size_t* bytes);
+extern void confignode_arena_free(confignode_arena* arena);
+extern void confignode_arena_attach(confignode* parent, confignode* sub);
+extern void confignode_arena_detach(confignode* parent, confignode* sub);
+extern void confignode_arena_release(confignode* node);
+extern void* confignode_alloc(confignode_arena* arena, size_t size);
+extern void confignode_free(confignode_arena* arena, void* ptr);
+extern void* confignode_realloc(confignode_arena* arena, void* ptr, size_t old, size_t size);
+extern char* confignode_strdup(confignode_arena* arena, const char* str);
 extern void configfile_array_fixup(confignode* node);
+extern void confignode_array_remove(confignode* node, confignode* sub);
 extern bool confignode_set_key(confignode* node, const char* key);
+extern uint32_t confignode_key_hash(const char* key);
+extern bool confignode_map_append(confignode* node, confignode* sub);
+extern void confignode_map_remove(confignode* node, confignode* sub);
+extern void confignode_map_resolve(confignode* node, const char* key);
+extern void confignode_hash_free(confignode* node);
 extern confignode* confignode_from_json(json_object* obj);
 extern json_object* confignode_to_json(confignode* node);
 extern confignode* configfile_json_load_string(const char* buff);
@@ -63,6 +63,7 @@ bool confignode_iter_start(confignode_iter* iter, confignode* node) {
 		node->type != CONFIGNODE_TYPE_MAP &&
 		node->type != CONFIGNODE_TYPE_ARRAY
 	) return false;
+	if (node->resolver) confignode_map_resolve(node, NULL);
 	iter->root = node, iter->cur = NULL, iter->node = NULL;
 	iter->index = -1, iter->name = NULL;
 	return confignode_iter_next(iter);
@@ -96,6 +97,14 @@ confignode_iter confignode_iter_start_ret(confignode* node) {
  */
 bool confignode_iter_next(confignode_iter* iter) {
 	if (!iter || !iter->root) return false;
+	if (iter->root->type == CONFIGNODE_TYPE_ARRAY) {
+		size_t next = iter->index + 1;
+		if (next >= iter->root->array.len) goto end;
+		iter->node = iter->root->array.data[next];
+		iter->index = next;
+		iter->name = iter->node->key ? iter->node->key : NULL;
+		return true;
+	}
 	do {
 		list* next = iter->cur ?
 			((list*) iter->cur)->next :
@@ -126,4 +135,5 @@ end:
 void confignode_iter_reset(confignode_iter* iter) {
 	if (!iter || !iter->root) return;
 	iter->cur = NULL, iter->node = NULL;
+	iter->index = -1;
 }
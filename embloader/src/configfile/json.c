@@ -1,5 +1,6 @@
 #include <string.h>
 #include "internal.h"
+#include "log.h"
 
 /**
  * @brief Convert a json_object to a confignode tree.
@@ -90,10 +91,8 @@ json_object* confignode_to_json(confignode* node) {
 		case CONFIGNODE_TYPE_ARRAY: {
 			json_object* arr = json_object_new_array();
 			if (!arr) return NULL;
-			list* p;
-			if ((p = list_first(node->items))) do {
-				LIST_DATA_DECLARE(i, p, confignode*);
-				if (!i) continue;
+			for (size_t idx = 0; idx < node->array.len; idx++) {
+				confignode* i = node->array.data[idx];
 				json_object* sub = confignode_to_json(i);
 				if (!sub) {
 					json_object_put(arr);
@@ -104,13 +103,14 @@ json_object* confignode_to_json(confignode* node) {
 					json_object_put(arr);
 					return NULL;
 				}
-			} while ((p = p->next));
+			}
 			return arr;
 		}
 		case CONFIGNODE_TYPE_MAP: {
 			json_object* obj = json_object_new_object();
 			if (!obj) return NULL;
 			list* p;
+			confignode_map_resolve(node, NULL);
 			if ((p = list_first(node->items))) do {
 				LIST_DATA_DECLARE(i, p, confignode*);
 				if (!i || !i->key) continue;
@@ -132,11 +132,281 @@ json_object* confignode_to_json(confignode* node) {
 	}
 }
 
+#define JSON_MAX_DEPTH 32
+
+struct json_parser {
+	const char* p;
+	const char* line_start;
+	int line;
+	const char* error;
+	char* stack;
+	size_t stack_len;
+	size_t stack_size;
+};
+
+static confignode* json_parse_value(struct json_parser* ctx, int depth);
+
+static bool json_error(struct json_parser* ctx, const char* error) {
+	if (!ctx->error) ctx->error = error;
+	return false;
+}
+
+static bool json_skip_space(struct json_parser* ctx) {
+	for (;;) switch (*ctx->p) {
+		case '\n':
+			ctx->line++;
+			ctx->line_start = ++ctx->p;
+			break;
+		case ' ': case '\t': case '\r':
+			ctx->p++;
+			break;
+		case '/':
+			if (ctx->p[1] == '/') {
+				while (*ctx->p && *ctx->p != '\n') ctx->p++;
+			} else if (ctx->p[1] == '*') {
+				ctx->p += 2;
+				while (*ctx->p && !(ctx->p[0] == '*' && ctx->p[1] == '/')) {
+					if (*ctx->p == '\n') ctx->line++, ctx->line_start = ctx->p + 1;
+					ctx->p++;
+				}
+				if (!*ctx->p) return json_error(ctx, "unterminated comment");
+				ctx->p += 2;
+			} else return true;
+			break;
+		default:
+			return true;
+	}
+}
+
+static bool json_stack_put(struct json_parser* ctx, const char* data, size_t len) {
+	if (ctx->stack_len + len > ctx->stack_size) {
+		size_t size = ctx->stack_size ? ctx->stack_size : 256;
+		while (size < ctx->stack_len + len) size *= 2;
+		char* stack = realloc(ctx->stack, size);
+		if (!stack) return json_error(ctx, "out of memory");
+		ctx->stack = stack;
+		ctx->stack_size = size;
+	}
+	memcpy(ctx->stack + ctx->stack_len, data, len);
+	ctx->stack_len += len;
+	return true;
+}
+
+static bool json_put_utf8(struct json_parser* ctx, uint32_t c) {
+	char buf[4];
+	size_t len;
+	if (c < 0x80) buf[0] = c, len = 1;
+	else if (c < 0x800) {
+		buf[0] = 0xC0 | (c >> 6);
+		buf[1] = 0x80 | (c & 0x3F);
+		len = 2;
+	} else if (c < 0x10000) {
+		buf[0] = 0xE0 | (c >> 12);
+		buf[1] = 0x80 | ((c >> 6) & 0x3F);
+		buf[2] = 0x80 | (c & 0x3F);
+		len = 3;
+	} else {
+		buf[0] = 0xF0 | (c >> 18);
+		buf[1] = 0x80 | ((c >> 12) & 0x3F);
+		buf[2] = 0x80 | ((c >> 6) & 0x3F);
+		buf[3] = 0x80 | (c & 0x3F);
+		len = 4;
+	}
+	return json_stack_put(ctx, buf, len);
+}
+
+static bool json_parse_hex4(struct json_parser* ctx, uint32_t* out) {
+	uint32_t c = 0;
+	for (int i = 0; i < 4; i++) {
+		char h = *ctx->p;
+		c <<= 4;
+		if (h >= '0' && h <= '9') c |= h - '0';
+		else if (h >= 'a' && h <= 'f') c |= h - 'a' + 10;
+		else if (h >= 'A' && h <= 'F') c |= h - 'A' + 10;
+		else return json_error(ctx, "invalid unicode escape");
+		ctx->p++;
+	}
+	*out = c;
+	return true;
+}
+
+static bool json_parse_string(struct json_parser* ctx, size_t* off) {
+	char quote = *ctx->p++;
+	*off = ctx->stack_len;
+	for (;;) {
+		const char* start = ctx->p;
+		while (*ctx->p && *ctx->p != quote && *ctx->p != '\\') {
+			if (*ctx->p == '\n') ctx->line++, ctx->line_start = ctx->p + 1;
+			ctx->p++;
+		}
+		if (ctx->p > start && !json_stack_put(ctx, start, ctx->p - start))
+			return false;
+		if (!*ctx->p) return json_error(ctx, "unterminated string");
+		if (*ctx->p == quote) {
+			ctx->p++;
+			return json_stack_put(ctx, "", 1);
+		}
+		uint32_t c;
+		char e;
+		switch ((e = *++ctx->p)) {
+			case 'b': e = '\b'; break;
+			case 'f': e = '\f'; break;
+			case 'n': e = '\n'; break;
+			case 'r': e = '\r'; break;
+			case 't': e = '\t'; break;
+			case '"': case '\'': case '\\': case '/': break;
+			case 'u':
+				ctx->p++;
+				if (!json_parse_hex4(ctx, &c)) return false;
+				if (c >= 0xD800 && c <= 0xDBFF && ctx->p[0] == '\\' && ctx->p[1] == 'u') {
+					uint32_t lo;
+					ctx->p += 2;
+					if (!json_parse_hex4(ctx, &lo)) return false;
+					if (lo >= 0xDC00 && lo <= 0xDFFF)
+						c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+					else if (!json_put_utf8(ctx, c)) return false;
+					else c = lo;
+				}
+				if (!json_put_utf8(ctx, c)) return false;
+				continue;
+			default:
+				return json_error(ctx, "invalid escape sequence");
+		}
+		ctx->p++;
+		if (!json_stack_put(ctx, &e, 1)) return false;
+	}
+}
+
+static confignode* json_parse_number(struct json_parser* ctx) {
+	const char* start = ctx->p;
+	bool is_float = false;
+	char* end = NULL;
+	if (*ctx->p == '-') ctx->p++;
+	if (*ctx->p < '0' || *ctx->p > '9') {
+		json_error(ctx, "invalid number");
+		return NULL;
+	}
+	while (*ctx->p >= '0' && *ctx->p <= '9') ctx->p++;
+	if (*ctx->p == '.') {
+		is_float = true;
+		ctx->p++;
+		while (*ctx->p >= '0' && *ctx->p <= '9') ctx->p++;
+	}
+	if (*ctx->p == 'e' || *ctx->p == 'E') {
+		is_float = true;
+		ctx->p++;
+		if (*ctx->p == '+' || *ctx->p == '-') ctx->p++;
+		while (*ctx->p >= '0' && *ctx->p <= '9') ctx->p++;
+	}
+	if (is_float) {
+		double f = strtod(start, &end);
+		if (end != ctx->p) {
+			json_error(ctx, "invalid number");
+			return NULL;
+		}
+		return confignode_new_float(f);
+	}
+	return confignode_new_int(strtoll(start, &end, 10));
+}
+
+static confignode* json_parse_container(struct json_parser* ctx, int depth) {
+	bool map = *ctx->p++ == '{';
+	char close = map ? '}' : ']';
+	confignode* node = map ? confignode_new_map() : confignode_new_array();
+	if (!node) {
+		json_error(ctx, "out of memory");
+		return NULL;
+	}
+	if (depth >= JSON_MAX_DEPTH) {
+		json_error(ctx, "nesting too deep");
+		goto fail;
+	}
+	for (;;) {
+		size_t key = 0;
+		if (!json_skip_space(ctx)) goto fail;
+		if (*ctx->p == close) break;
+		if (map) {
+			if (*ctx->p != '"' && *ctx->p != '\'') {
+				json_error(ctx, "expected object key");
+				goto fail;
+			}
+			if (!json_parse_string(ctx, &key) || !json_skip_space(ctx)) goto fail;
+			if (*ctx->p++ != ':') {
+				ctx->p--;
+				json_error(ctx, "expected ':'");
+				goto fail;
+			}
+		}
+		confignode* sub = json_parse_value(ctx, depth + 1);
+		if (!sub) goto fail;
+		bool ok = map ?
+			confignode_map_set(node, ctx->stack + key, sub) :
+			confignode_array_append(node, sub);
+		if (map) ctx->stack_len = key;
+		if (!ok) {
+			confignode_clean(sub);
+			json_error(ctx, "out of memory");
+			goto fail;
+		}
+		if (!json_skip_space(ctx)) goto fail;
+		if (*ctx->p == ',') ctx->p++;
+		else if (*ctx->p != close) {
+			json_error(ctx, map ? "expected ',' or '}'" : "expected ',' or ']'");
+			goto fail;
+		}
+	}
+	ctx->p++;
+	return node;
+fail:
+	confignode_clean(node);
+	return NULL;
+}
+
+static bool json_match(struct json_parser* ctx, const char* word) {
+	size_t len = strlen(word);
+	if (strncmp(ctx->p, word, len) != 0) return false;
+	ctx->p += len;
+	return true;
+}
+
+static confignode* json_parse_value(struct json_parser* ctx, int depth) {
+	size_t off;
+	confignode* node;
+	if (!json_skip_space(ctx)) return NULL;
+	switch (*ctx->p) {
+		case '{': case '[':
+			return json_parse_container(ctx, depth);
+		case '"': case '\'':
+			if (!json_parse_string(ctx, &off)) return NULL;
+			node = confignode_new_string(ctx->stack + off);
+			ctx->stack_len = off;
+			if (!node) json_error(ctx, "out of memory");
+			return node;
+		case '-': case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			if (!(node = json_parse_number(ctx))) json_error(ctx, "out of memory");
+			return node;
+		case 0:
+			json_error(ctx, "unexpected end of input");
+			return NULL;
+	}
+	if (json_match(ctx, "true")) node = confignode_new_bool(true);
+	else if (json_match(ctx, "false")) node = confignode_new_bool(false);
+	else if (json_match(ctx, "null")) node = confignode_new();
+	else {
+		json_error(ctx, "unexpected character");
+		return NULL;
+	}
+	if (!node) json_error(ctx, "out of memory");
+	return node;
+}
+
 /**
  * @brief Load a confignode tree from a JSON string.
- * Parses the JSON string and converts it to a confignode tree structure.
- * This is a convenience function that combines json_tokener_parse and
- * confignode_from_json.
+ * The JSON text is tokenized in a single pass and confignode MAP, ARRAY and
+ * VALUE nodes are created directly, without an intermediate json_object
+ * tree. Comments and single quoted strings are accepted like the non-strict
+ * json-c tokenizer, parse errors are logged with line and column.
  *
  * @param buff the JSON string to parse (must be null-terminated)
  * @return newly allocated confignode tree, or NULL on parse error or allocation
@@ -144,10 +414,23 @@ json_object* confignode_to_json(confignode* node) {
  *
  */
 confignode* configfile_json_load_string(const char* buff) {
-	json_object* obj = json_tokener_parse(buff);
-	if (!obj) return NULL;
-	confignode* node = confignode_from_json(obj);
-	json_object_put(obj);
+	struct json_parser ctx;
+	if (!buff) return NULL;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.p = ctx.line_start = buff;
+	ctx.line = 1;
+	confignode* node = json_parse_value(&ctx, 0);
+	if (node && (!json_skip_space(&ctx) || *ctx.p)) {
+		json_error(&ctx, "trailing characters after value");
+		confignode_clean(node);
+		node = NULL;
+	}
+	if (!node) log_warning(
+		"parse json failed at line %d column %d: %s",
+		ctx.line, (int) (ctx.p - ctx.line_start) + 1,
+		ctx.error ?: "unknown error"
+	);
+	if (ctx.stack) free(ctx.stack);
 	return node;
 }
 
@@ -2,27 +2,252 @@
 #include "internal.h"
 #include "debugs.h"
 
+#define MAP_HASH_MIN 8
+
+static list hash_deleted;
+
 /**
- * @brief Get a child node from a map-type config node by key name.
+ * @brief Calculate the hash of a map key (FNV-1a).
  *
- * @param node the map-type node to get child from
- * @param key the key name of the child node to retrieve
- * @return the child node with the specified key, or NULL if not found or
- * invalid parameters
+ * @param key the key string to hash
+ * @return the 32-bit hash value
  *
  */
-confignode* confignode_map_get(confignode* node, const char* key) {
-	if (!node || node->type != CONFIGNODE_TYPE_MAP) return NULL;
+uint32_t confignode_key_hash(const char* key) {
+	uint32_t h = 2166136261u;
+	if (key) while (*key) h = (h ^ (uint8_t) *key++) * 16777619u;
+	return h;
+}
+
+/**
+ * @brief Free the hash index of a map-type config node.
+ * The index is rebuilt on the next lookup when the map is large enough.
+ *
+ * @param node the map-type node to drop index from
+ *
+ */
+void confignode_hash_free(confignode* node) {
+	if (!node || !node->hash) return;
+	confignode_free(node->arena, node->hash->slots);
+	confignode_free(node->arena, node->hash);
+	node->hash = NULL;
+}
+
+static bool hash_insert(confignode_hash* hash, list* entry) {
+	confignode* n = entry->data;
+	size_t mask = hash->size - 1, i = n->keyhash & mask;
+	while (hash->slots[i] && hash->slots[i] != &hash_deleted)
+		i = (i + 1) & mask;
+	if (!hash->slots[i]) hash->filled++;
+	hash->slots[i] = entry;
+	hash->used++;
+	return true;
+}
+
+static bool hash_build(confignode* node, size_t count) {
 	list* p;
+	confignode_hash* hash;
+	size_t size = 16;
+	while (size < count * 2) size <<= 1;
+	if (!(hash = confignode_alloc(node->arena, sizeof(confignode_hash))))
+		return false;
+	memset(hash, 0, sizeof(confignode_hash));
+	if (!(hash->slots = confignode_alloc(node->arena, sizeof(list*) * size))) {
+		confignode_free(node->arena, hash);
+		return false;
+	}
+	memset(hash->slots, 0, sizeof(list*) * size);
+	hash->size = size;
 	if ((p = list_first(node->items))) do {
 		LIST_DATA_DECLARE(n, p, confignode*);
+		hash->tail = p;
 		if (!n || n->parent != node || !n->key) continue;
-		if (strcmp(key, n->key) != 0) continue;
-		return n;
+		hash_insert(hash, p);
 	} while ((p = p->next));
+	confignode_hash_free(node);
+	node->hash = hash;
+	return true;
+}
+
+static list* map_entry_new(confignode* node, confignode* sub) {
+	list* entry = confignode_alloc(node->arena, sizeof(list));
+	if (!entry) return NULL;
+	memset(entry, 0, sizeof(list));
+	entry->data = sub;
+	return entry;
+}
+
+static void map_entry_del(confignode* node, list* entry) {
+	list_obj_strip(&node->items, entry);
+	confignode_free(node->arena, entry);
+}
+
+static list* hash_find(confignode_hash* hash, const char* key, uint32_t h) {
+	size_t mask = hash->size - 1, i = h & mask;
+	while (hash->slots[i]) {
+		if (hash->slots[i] != &hash_deleted) {
+			LIST_DATA_DECLARE(n, hash->slots[i], confignode*);
+			if (n->keyhash == h && strcmp(key, n->key) == 0)
+				return hash->slots[i];
+		}
+		i = (i + 1) & mask;
+	}
 	return NULL;
 }
 
+static list* map_find_entry(confignode* node, const char* key) {
+	list *p, *found = NULL;
+	size_t count = 0;
+	if (node->hash) return hash_find(node->hash, key, confignode_key_hash(key));
+	if ((p = list_first(node->items))) do {
+		LIST_DATA_DECLARE(n, p, confignode*);
+		count++;
+		if (found || !n || n->parent != node || !n->key) continue;
+		if (strcmp(key, n->key) == 0) found = p;
+	} while ((p = p->next));
+	if (count >= MAP_HASH_MIN) hash_build(node, count);
+	return found;
+}
+
+/**
+ * @brief Append a child node to a map-type config node without checking
+ * for an existing key. The child key must already be set.
+ *
+ * @param node the map-type node to append to
+ * @param sub the child node to append
+ * @return true on success, false on allocation failure
+ *
+ */
+bool confignode_map_append(confignode* node, confignode* sub) {
+	confignode_hash* hash = node->hash;
+	list* entry = map_entry_new(node, sub);
+	if (!entry) return false;
+	confignode_generation++;
+	if (hash && hash->tail) list_add(hash->tail, entry);
+	else list_obj_add(&node->items, entry);
+	if (hash) hash->tail = entry;
+	sub->parent = node;
+	confignode_arena_attach(node, sub);
+	if (!hash) return true;
+	if ((hash->filled + 1) * 4 >= hash->size * 3) {
+		if (!hash_build(node, hash->used + 1)) confignode_hash_free(node);
+	} else hash_insert(hash, hash->tail);
+	return true;
+}
+
+/**
+ * @brief Remove a child node from a map-type config node and its index.
+ * The child node itself is not freed.
+ *
+ * @param node the map-type node to remove from
+ * @param sub the child node to remove
+ *
+ */
+void confignode_map_remove(confignode* node, confignode* sub) {
+	list* entry = NULL;
+	confignode_hash* hash = node->hash;
+	confignode_generation++;
+	if (hash && sub->key) {
+		size_t mask = hash->size - 1, i = sub->keyhash & mask;
+		while (hash->slots[i]) {
+			if (hash->slots[i] != &hash_deleted && hash->slots[i]->data == sub) {
+				entry = hash->slots[i];
+				hash->slots[i] = &hash_deleted;
+				hash->used--;
+				break;
+			}
+			i = (i + 1) & mask;
+		}
+		if (entry && entry == hash->tail) hash->tail = entry->prev;
+	}
+	if (!entry) {
+		entry = list_lookup_data(node->items, sub);
+		confignode_hash_free(node);
+	}
+	if (entry) map_entry_del(node, entry);
+}
+
+/**
+ * @brief Get a child node from a map-type config node by key name.
+ * Maps with many children keep a hash index, so lookup does not need to
+ * walk all children.
+ *
+ * @param node the map-type node to get child from
+ * @param key the key name of the child node to retrieve
+ * @return the child node with the specified key, or NULL if not found or
+ * invalid parameters
+ *
+ */
+confignode* confignode_map_get(confignode* node, const char* key) {
+	if (!node || !key || node->type != CONFIGNODE_TYPE_MAP) return NULL;
+	list* p = map_find_entry(node, key);
+	if (!p && node->resolver) {
+		confignode_map_resolve(node, key);
+		p = map_find_entry(node, key);
+	}
+	return p ? p->data : NULL;
+}
+
+/**
+ * @brief Get a child node from a map-type config node by key name and a
+ * precalculated key hash.
+ *
+ * @param node the map-type node to get child from
+ * @param key the key name of the child node to retrieve
+ * @param hash the hash of key from confignode_key_hash
+ * @return the child node with the specified key, or NULL if not found
+ *
+ */
+confignode* confignode_map_get_hash(confignode* node, const char* key, uint32_t hash) {
+	if (!node || !key || node->type != CONFIGNODE_TYPE_MAP) return NULL;
+	list* p = node->hash ?
+		hash_find(node->hash, key, hash) :
+		map_find_entry(node, key);
+	if (!p && node->resolver) return confignode_map_get(node, key);
+	return p ? p->data : NULL;
+}
+
+/**
+ * @brief Attach a resolver that fills children of a map-type node lazily.
+ * The resolver runs when a missing key is looked up, and once for all keys
+ * before the node is iterated, copied or serialized.
+ *
+ * @param node the map-type node
+ * @param resolver the resolver callback, or NULL to remove it
+ * @param data user data passed to the resolver
+ * @return true on success, false if node is not a map
+ *
+ */
+bool confignode_map_set_resolver(
+	confignode* node,
+	confignode_resolver resolver,
+	void* data
+) {
+	if (!node || node->type != CONFIGNODE_TYPE_MAP) return false;
+	node->resolver = resolver;
+	node->resolver_data = resolver ? data : NULL;
+	return true;
+}
+
+/**
+ * @brief Run the resolver of a lazy map-type node.
+ * The resolver is detached while it runs, so it can fill the node with the
+ * normal map functions, and dropped once every key was requested.
+ *
+ * @param node the map-type node
+ * @param key the missing key, or NULL to resolve all children
+ *
+ */
+void confignode_map_resolve(confignode* node, const char* key) {
+	confignode_resolver resolver;
+	if (!node || !(resolver = node->resolver)) return;
+	void* data = node->resolver_data;
+	node->resolver = NULL;
+	node->resolver_data = NULL;
+	if (resolver(node, key, data) && key && !node->resolver)
+		confignode_map_set_resolver(node, resolver, data);
+}
+
 /**
  * @brief Create a new map-type config node.
  *
@@ -50,23 +275,17 @@ confignode* confignode_new_map() {
 bool confignode_map_set(confignode* node, const char* key, confignode* sub) {
 	if (!node || !key || !sub || sub->parent) return false;
 	if (node->type != CONFIGNODE_TYPE_MAP) return false;
-	list* p;
-	bool found = false;
-	if ((p = list_first(node->items))) do {
-		LIST_DATA_DECLARE(n, p, confignode*);
-		if (!n || n->parent != node) continue;
-		if (strcmp(key, n->key) != 0) continue;
-		confignode_clean(n);
-		p->data = sub;
-		found = true;
-		break;
-	} while ((p = p->next));
-	if (!found) {
-		int st = list_obj_add_new(&node->items, sub);
-		if (st != 0) return false;
-	}
-	confignode_set_key(sub, key);
+	list* p = map_find_entry(node, key);
+	if (!confignode_set_key(sub, key)) return false;
+	if (!p) return confignode_map_append(node, sub);
+	LIST_DATA_DECLARE(n, p, confignode*);
+	confignode_generation++;
+	confignode_arena_detach(node, n);
+	n->parent = NULL;
+	confignode_clean(n);
+	p->data = sub;
 	sub->parent = node;
+	confignode_arena_attach(node, sub);
 	return true;
 }
 
@@ -19,24 +19,21 @@ confignode* confignode_copy(confignode* node) {
 		case CONFIGNODE_TYPE_ARRAY: {
 			confignode* a = confignode_new_array();
 			if (!a) return NULL;
-			list* p;
-			if ((p = list_first(node->items))) do {
-					LIST_DATA_DECLARE(i, p, confignode*);
-					confignode* copy = confignode_copy(i);
-					if (!copy) {
-						confignode_clean(a);
-						return NULL;
-					}
-					copy->parent = a;
-					list_obj_add_new(&a->items, copy);
-				} while ((p = p->next));
-			configfile_array_fixup(a);
+			for (size_t i = 0; i < node->array.len; i++) {
+				confignode* copy = confignode_copy(node->array.data[i]);
+				if (!copy || !confignode_array_append(a, copy)) {
+					if (copy) confignode_clean(copy);
+					confignode_clean(a);
+					return NULL;
+				}
+			}
 			return a;
 		}
 		case CONFIGNODE_TYPE_MAP: {
 			confignode* m = confignode_new_map();
 			if (!m) return NULL;
 			list* p;
+			confignode_map_resolve(node, NULL);
 			if ((p = list_first(node->items))) do {
 					LIST_DATA_DECLARE(i, p, confignode*);
 					confignode* copy = confignode_copy(i);
@@ -44,9 +41,14 @@ confignode* confignode_copy(confignode* node) {
 						confignode_clean(m);
 						return NULL;
 					}
-					confignode_set_key(copy, i->key);
-					copy->parent = m;
-					list_obj_add_new(&m->items, copy);
+					if (
+						!confignode_set_key(copy, i->key) ||
+						!confignode_map_append(m, copy)
+					) {
+						confignode_clean(copy);
+						confignode_clean(m);
+						return NULL;
+					}
 				} while ((p = p->next));
 			return m;
 		}
@@ -72,20 +74,32 @@ bool confignode_replace(confignode** node, confignode* new) {
 		(*node)->parent->type != CONFIGNODE_TYPE_ARRAY
 	) return false;
 	bool found = false;
-	list* p;
-	if ((p = list_first((*node)->parent->items))) do {
-		LIST_DATA_DECLARE(n, p, confignode*);
-		if (n != (*node)) continue;
-		p->data = new;
-		found = true;
-		break;
-	} while ((p = p->next));
+	confignode* parent = (*node)->parent;
+	if (parent->type == CONFIGNODE_TYPE_ARRAY) {
+		ssize_t idx = (*node)->index;
+		if (idx >= 0 && (size_t) idx < parent->array.len && parent->array.data[idx] == *node) {
+			parent->array.data[idx] = new;
+			found = true;
+		}
+	} else {
+		list* p;
+		if ((p = list_first(parent->items))) do {
+			LIST_DATA_DECLARE(n, p, confignode*);
+			if (n != (*node)) continue;
+			p->data = new;
+			found = true;
+			break;
+		} while ((p = p->next));
+	}
 	if (!found) return false;
+	confignode_generation++;
 	if ((*node)->parent->type == CONFIGNODE_TYPE_MAP)
 		confignode_set_key(new, (*node)->key);
 	if ((*node)->parent->type == CONFIGNODE_TYPE_ARRAY)
 		new->index = (*node)->index;
 	new->parent = (*node)->parent;
+	confignode_arena_attach(new->parent, new);
+	confignode_arena_detach((*node)->parent, *node);
 	(*node)->parent = NULL;
 	confignode_clean(*node);
 	*node = new;
@@ -109,9 +123,8 @@ bool confignode_merge(confignode* node, confignode* new) {
 		node->type != CONFIGNODE_TYPE_MAP &&
 		node->type != CONFIGNODE_TYPE_ARRAY
 	) return confignode_replace(&node, confignode_copy(new));
-	list* p;
-	if ((p = list_first(new->items))) do {
-		LIST_DATA_DECLARE(n, p, confignode*);
+	confignode_foreach(iter, new) {
+		confignode* n = iter.node;
 		if (!n || n->parent != new) continue;
 		bool r = false;
 		if (node->type == CONFIGNODE_TYPE_ARRAY) {
@@ -122,6 +135,66 @@ bool confignode_merge(confignode* node, confignode* new) {
 			else r = confignode_map_set(node, n->key, confignode_copy(n));
 		}
 		if (!r) return false;
-	} while ((p = p->next));
+	}
 	return true;
 }
+
+static void merge_steal_reset(confignode* node) {
+	node->array.len = 0;
+	confignode_hash_free(node);
+	if (!node->arena) list_free_all(node->items, NULL);
+	node->items = NULL;
+}
+
+/**
+ * @brief Merge a config node tree into another by moving its nodes.
+ * Same as confignode_merge, but child nodes of new are relinked into the
+ * target instead of being copied. The source tree is consumed and freed in
+ * any case, so it must not be used after this call.
+ *
+ * @param node the target node to merge into
+ * @param new the source node to merge from, freed by this function
+ * @return true on success, false if parameters are invalid or operation failed
+ *
+ */
+bool confignode_merge_steal(confignode* node, confignode* new) {
+	bool ret = true;
+	if (!new) return false;
+	if (new->parent) {
+		confignode* parent = new->parent;
+		if (parent->type == CONFIGNODE_TYPE_MAP)
+			confignode_map_remove(parent, new);
+		else if (parent->type == CONFIGNODE_TYPE_ARRAY)
+			confignode_array_remove(parent, new);
+		confignode_arena_detach(parent, new);
+		new->parent = NULL;
+	}
+	if (!node || (
+		node->type != CONFIGNODE_TYPE_MAP &&
+		node->type != CONFIGNODE_TYPE_ARRAY
+	)) {
+		if (node && confignode_replace(&node, new)) return true;
+		confignode_clean(new);
+		return false;
+	}
+	confignode_foreach(iter, new) {
+		confignode* n = iter.node;
+		if (!n || n->parent != new) continue;
+		confignode_arena_detach(new, n);
+		n->parent = NULL;
+		if (!ret) {
+			confignode_clean(n);
+		} else if (node->type == CONFIGNODE_TYPE_ARRAY) {
+			if (!(ret = confignode_array_append(node, n)))
+				confignode_clean(n);
+		} else if (node->type == CONFIGNODE_TYPE_MAP) {
+			confignode* s = confignode_map_get(node, n->key);
+			if (s) ret = confignode_merge_steal(s, n);
+			else if (!(ret = confignode_map_set(node, n->key, n)))
+				confignode_clean(n);
+		}
+	}
+	merge_steal_reset(new);
+	confignode_clean(new);
+	return ret;
+}
@@ -1,5 +1,20 @@
 #include "internal.h"
 
+uint64_t confignode_generation = 1;
+
+/**
+ * @brief Get the modification counter of the config trees.
+ * The counter changes whenever a node of any tree is added, removed, renamed
+ * or gets a new value, so anything cached from a tree (node pointers, value
+ * strings) is only valid while the counter keeps the same value.
+ *
+ * @return the current modification counter
+ *
+ */
+uint64_t confignode_get_generation() {
+	return confignode_generation;
+}
+
 /**
  * @brief Get the type of a config node.
  *
@@ -57,8 +72,10 @@ int64_t confignode_get_index(confignode* node) {
  */
 bool confignode_is_empty(confignode* node) {
 	if (!node) return true;
-	if (node->type == CONFIGNODE_TYPE_MAP || node->type == CONFIGNODE_TYPE_ARRAY)
-		return !node->items || list_count(node->items) == 0;
+	if (node->type == CONFIGNODE_TYPE_MAP)
+		return !node->resolver && (!node->items || list_count(node->items) == 0);
+	if (node->type == CONFIGNODE_TYPE_ARRAY)
+		return node->array.len == 0;
 	if (node->type == CONFIGNODE_TYPE_VALUE) switch (node->value.type) {
 		case VALUE_STRING:
 			return !node->value.v.s || !node->value.v.s[0];
@@ -105,9 +122,11 @@ confignode* confignode_root(confignode* node) {
  */
 confignode* confignode_new() {
 	confignode* n;
-	n = malloc(sizeof(confignode));
+	confignode_arena* arena = confignode_arena_current();
+	n = confignode_alloc(arena, sizeof(confignode));
 	if (!n) return NULL;
 	memset(n, 0, sizeof(confignode));
+	n->arena = confignode_arena_get(arena);
 	n->index = -1;
 	n->type = CONFIGNODE_TYPE_NULL;
 	return n;
@@ -123,10 +142,14 @@ confignode* confignode_new() {
  */
 bool confignode_set_key(confignode* node, const char* key) {
 	if (!node) return false;
-	if (node->key) free(node->key);
+	if (key && key == node->key) return true;
+	confignode_generation++;
+	confignode_free(node->arena, node->key);
 	node->key = NULL;
+	node->keyhash = 0;
 	if (!key) return true;
-	node->key = strdup(key);
+	node->key = confignode_strdup(node->arena, key);
+	node->keyhash = confignode_key_hash(key);
 	return node->key != NULL;
 }
 
@@ -140,23 +163,42 @@ bool confignode_set_key(confignode* node, const char* key) {
  */
 void confignode_clean(confignode* node) {
 	if (!node) return;
+	confignode_generation++;
 	if (node->parent) {
-		list_obj_del_data(&node->parent->items, node, NULL);
-		configfile_array_fixup(node->parent);
+		if (node->parent->type == CONFIGNODE_TYPE_MAP)
+			confignode_map_remove(node->parent, node);
+		else if (node->parent->type == CONFIGNODE_TYPE_ARRAY)
+			confignode_array_remove(node->parent, node);
+		confignode_arena_detach(node->parent, node);
+		node->parent = NULL;
 	}
+	if (node->arena) {
+		confignode_arena_release(node);
+		return;
+	}
+	confignode_hash_free(node);
 	if (node->key) free(node->key);
 	if (node->value.type == VALUE_STRING && node->value.v.s)
 		free(node->value.v.s);
+	if (node->text) free(node->text);
 	if (node->items) {
 		list *p, *n;
 		if ((p = list_first(node->items))) do {
 			n = p->next;
 			LIST_DATA_DECLARE(i, p, confignode*);
 			if (!i || i->parent != node) continue;
+			i->parent = NULL;
 			confignode_clean(i);
 		} while ((p = n));
 		list_free_all(node->items, NULL);
 	}
+	if (node->array.data) {
+		for (size_t i = 0; i < node->array.len; i++) {
+			node->array.data[i]->parent = NULL;
+			confignode_clean(node->array.data[i]);
+		}
+		free(node->array.data);
+	}
 	memset(node, 0, sizeof(confignode));
 	free(node);
 }
@@ -16,17 +16,17 @@
 confignode* confignode_path_lookup(confignode* node, const char* path, bool create) {
 	if (!node || !path) return NULL;
 	if (!path[0]) return node;
-	char *np, *nstr, *npath = NULL;
+	char buff[64], *key = NULL;
+	const char *nstr, *npath = NULL;
 	confignode* next = NULL;
 	size_t len = strlen(path);
-	if (!(np = strdup(path))) return NULL;
 	if (path[0] == '[') {
 		size_t index = 0;
 		char* end = NULL;
-		if (!(nstr = memchr(np + 1, ']', len - 1)))
+		if (!(nstr = memchr(path + 1, ']', len - 1)))
 			goto cleanup;
-		*nstr = 0, npath = nstr + 1;
-		long long temp = strtoll(np + 1, &end, 10);
+		npath = nstr[1] == '.' ? nstr + 2 : nstr + 1;
+		long long temp = strtoll(path + 1, &end, 10);
 		if (temp < 0 || end != nstr) goto cleanup;
 		index = (size_t) temp;
 		if (node->type != CONFIGNODE_TYPE_ARRAY) {
@@ -41,24 +41,132 @@ confignode* confignode_path_lookup(confignode* node, const char* path, bool crea
 			if (!confignode_array_set(node, index, next)) goto cleanup;
 		}
 	} else {
-		if ((nstr = strpbrk(np, ".["))) *nstr = 0, npath = nstr + 1;
+		size_t klen = len;
+		if ((nstr = strpbrk(path, ".[")))
+			klen = nstr - path, npath = *nstr == '[' ? nstr : nstr + 1;
+		if (!(key = klen < sizeof(buff) ? buff : malloc(klen + 1)))
+			goto cleanup;
+		memcpy(key, path, klen);
+		key[klen] = 0;
 		if (node->type != CONFIGNODE_TYPE_MAP) {
 			if (!create || !node->parent) goto cleanup;
 			confignode_replace(&node, confignode_new_map());
 			if (node->type != CONFIGNODE_TYPE_MAP) goto cleanup;
 		}
-		if (!(next = confignode_map_get(node, np))) {
+		if (!(next = confignode_map_get(node, key))) {
 			if (!create) goto cleanup;
 			next = confignode_new();
-			if (!confignode_map_set(node, np, next)) goto cleanup;
+			if (!confignode_map_set(node, key, next)) goto cleanup;
 		}
 	}
 	if (npath) next = confignode_path_lookup(next, npath, create);
 cleanup:
-	free(np);
+	if (key && key != buff) free(key);
 	return next;
 }
 
+struct confignode_path_seg {
+	const char* key;
+	uint32_t keyhash;
+	size_t index;
+};
+
+struct confignode_path {
+	size_t count;
+	confignode* root;
+	confignode* node;
+	uint64_t generation;
+	struct confignode_path_seg seg[];
+};
+
+/**
+ * @brief Compile a path string into a reusable path handle.
+ * Segments and array indices are split once, so resolving the handle walks
+ * the tree without parsing or allocating. Uses the same path format as
+ * confignode_path_lookup.
+ *
+ * @param path the path string to compile (e.g. "devicetree.overlays")
+ * @return newly allocated path handle, free with confignode_path_free, or
+ * NULL on invalid path or allocation failure
+ *
+ */
+confignode_path* confignode_path_compile(const char* path) {
+	confignode_path* cp;
+	size_t count = 1, len;
+	if (!path) return NULL;
+	len = strlen(path);
+	for (const char* p = path; *p; p++)
+		if (*p == '.' || *p == '[') count++;
+	size_t hdr = sizeof(confignode_path) + sizeof(struct confignode_path_seg) * count;
+	if (!(cp = malloc(hdr + len + 1))) return NULL;
+	memset(cp, 0, hdr);
+	char* buf = (char*) cp + hdr;
+	memcpy(buf, path, len + 1);
+	bool bracket = false;
+	char* p = buf;
+	while (*p || bracket) {
+		struct confignode_path_seg* seg = &cp->seg[cp->count++];
+		if (bracket || *p == '[') {
+			char* end = NULL;
+			if (!bracket) p++;
+			long long index = strtoll(p, &end, 10);
+			if (end == p || *end != ']' || index < 0) goto fail;
+			seg->index = (size_t) index;
+			p = end + 1, bracket = false;
+			if (*p == '.' && *++p == 0) goto fail;
+		} else {
+			char* end = p + strcspn(p, ".[");
+			if (end == p) goto fail;
+			bracket = *end == '[';
+			seg->key = p;
+			p = *end ? end + 1 : end;
+			if (*end == '.' && !*p) goto fail;
+			*end = 0;
+			seg->keyhash = confignode_key_hash(seg->key);
+		}
+	}
+	return cp;
+fail:
+	free(cp);
+	return NULL;
+}
+
+/**
+ * @brief Free a compiled path handle.
+ *
+ * @param path the path handle to free (may be NULL)
+ *
+ */
+void confignode_path_free(confignode_path* path) {
+	if (path) free(path);
+}
+
+/**
+ * @brief Resolve a compiled path handle against a config node tree.
+ * The resolved node is cached in the handle, repeated lookups on the same
+ * root are O(1) until any config tree is modified.
+ *
+ * @param node the root node to start lookup from
+ * @param path the compiled path handle
+ * @return the node at the path, or NULL if not found
+ *
+ */
+confignode* confignode_path_resolve(confignode* node, confignode_path* path) {
+	if (!node || !path) return NULL;
+	if (path->root == node && path->generation == confignode_generation)
+		return path->node;
+	confignode* n = node;
+	for (size_t i = 0; i < path->count && n; i++) {
+		struct confignode_path_seg* seg = &path->seg[i];
+		if (seg->key) n = confignode_map_get_hash(n, seg->key, seg->keyhash);
+		else n = confignode_array_get(n, seg->index);
+	}
+	path->root = node;
+	path->node = n;
+	path->generation = confignode_generation;
+	return n;
+}
+
 static void confignode_path_get_rec(confignode* node, char* buff, size_t size) {
 	if (!node->parent) return;
 	confignode_path_get_rec(node->parent, buff, size);
@@ -66,6 +66,46 @@ fail:
 	return def ? strdup(def) : NULL;
 }
 
+/**
+ * @brief Get a borrowed string view of a value node without allocating.
+ * String values are returned as is, booleans as static "true"/"false".
+ * Numbers are formatted once and kept with the node. The returned string
+ * is owned by the node and valid until the node is changed or freed.
+ *
+ * @param node the value node to get string from
+ * @param def default string to return if node is not a value
+ * @param len optional pointer to receive the string length
+ * @return the borrowed string, or def if not available
+ *
+ */
+const char* confignode_value_get_cstr(confignode* node, const char* def, size_t* len) {
+	const char* ret = NULL;
+	if (node && node->type == CONFIGNODE_TYPE_VALUE) switch (node->value.type) {
+		case VALUE_STRING:
+			ret = node->value.v.s;
+			break;
+		case VALUE_BOOL:
+			ret = node->value.v.b ? "true" : "false";
+			break;
+		case VALUE_INT:
+		case VALUE_FLOAT:
+			if (node->text) {
+				ret = node->text;
+				break;
+			}
+			if (!(node->text = confignode_alloc(node->arena, 32))) break;
+			if (node->value.type == VALUE_INT)
+				snprintf(node->text, 32, "%" PRId64, node->value.v.i);
+			else snprintf(node->text, 32, "%f", node->value.v.f);
+			ret = node->text;
+			break;
+		default:;
+	}
+	if (!ret) ret = def;
+	if (len) *len = ret ? strlen(ret) : 0;
+	return ret;
+}
+
 /**
  * @brief Get string list from a value node or array/map of values.
  * For VALUE nodes, returns a single-element list containing the string value.
@@ -275,10 +315,14 @@ bool confignode_value_set(confignode* node, const confignode_value* value) {
 	if (!node || node->type != CONFIGNODE_TYPE_VALUE || !value)
 		return false;
 	if (value->type == VALUE_STRING && !value->v.s) return false;
+	confignode_generation++;
 	if (node->value.type == VALUE_STRING && node->value.v.s)
-		free(node->value.v.s);
+		confignode_free(node->arena, node->value.v.s);
+	confignode_free(node->arena, node->text);
+	node->text = NULL;
 	memcpy(&node->value, value, sizeof(confignode_value));
 	if (value->type == VALUE_STRING)
-		if (!(node->value.v.s = strdup(value->v.s))) return false;
+		if (!(node->value.v.s = confignode_strdup(node->arena, value->v.s)))
+			return false;
 	return true;
 }
@@ -443,6 +443,29 @@ char* confignode_path_get_string(
 	return confignode_value_get_string(n, def, ok);
 }
 
+/**
+ * @brief Get a borrowed string view at the specified path without allocating.
+ *
+ * @param node the root node to start path lookup from
+ * @param path the path string pointing to the value
+ * @param def the default value to return if path doesn't exist
+ * @param len optional pointer to receive the string length
+ * @return string owned by the node, valid while the node lives, or def
+ *
+ * @see confignode_value_get_cstr()
+ *
+ */
+const char* confignode_path_get_cstr(
+	confignode* node,
+	const char* path,
+	const char* def,
+	size_t* len
+) {
+	return confignode_value_get_cstr(
+		confignode_path_lookup(node, path, false), def, len
+	);
+}
+
 /**
  * @brief Get an integer value at the specified path with default fallback.
  * Performs type conversion if the value exists but is not an integer.
@@ -250,11 +250,9 @@ static bool emit_yaml_node(yaml_emitter_t* emitter, confignode* node) {
 				&event, NULL, NULL, 1, YAML_BLOCK_SEQUENCE_STYLE
 			);
 			if (!yaml_emitter_emit(emitter, &event)) return false;
-			if ((p = list_first(node->items))) do {
-				LIST_DATA_DECLARE(child, p, confignode*);
-				if (child && !emit_yaml_node(emitter, child))
+			for (size_t i = 0; i < node->array.len; i++)
+				if (!emit_yaml_node(emitter, node->array.data[i]))
 					return false;
-			} while ((p = p->next));
 			yaml_sequence_end_event_initialize(&event);
 			if (!yaml_emitter_emit(emitter, &event)) return false;
 			break;
@@ -263,6 +261,7 @@ static bool emit_yaml_node(yaml_emitter_t* emitter, confignode* node) {
 				&event, NULL, NULL, 1, YAML_BLOCK_MAPPING_STYLE
 			);
 			if (!yaml_emitter_emit(emitter, &event)) return false;
+			confignode_map_resolve(node, NULL);
 			if ((p = list_first(node->items))) do {
 				LIST_DATA_DECLARE(
 					child, p, confignode*);
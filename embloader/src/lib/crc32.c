@@ -1,5 +1,4 @@
-#include <stdint.h>
-#include <stddef.h>
+#include "crc32.h"
 
 static const uint32_t crc_table[256] = {
 	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
@@ -47,10 +46,14 @@ static const uint32_t crc_table[256] = {
 	0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
 };
 
-uint32_t s_crc32(void* buffer, size_t length) {
-	uint8_t* ptr = buffer;
-	uint32_t crc = 0xffffffff;
+uint32_t s_crc32_update(uint32_t crc, const void* buffer, size_t length) {
+	const uint8_t* ptr = buffer;
+	crc ^= 0xffffffff;
 	for (size_t i = 0; i < length; i++, ptr++)
 		crc = (crc >> 8) ^ crc_table[(uint8_t) crc ^ *ptr];
 	return crc ^ 0xffffffff;
 }
+
+uint32_t s_crc32(void* buffer, size_t length) {
+	return s_crc32_update(0, buffer, length);
+}
@@ -10,6 +10,7 @@
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/DevicePathToText.h>
 #include <Guid/GlobalVariable.h>
+#include "crc32.h"
 #include "efi-utils.h"
 #include "variables.h"
 #include "encode.h"
@@ -142,7 +143,6 @@ void efi_table_calc_sum(void* table, size_t len) {
 	EFI_TABLE_HEADER* hdr = table;
 	if (!table || len < sizeof(EFI_TABLE_HEADER)) return;
 	hdr->CRC32 = 0;
-	extern uint32_t s_crc32(void* buffer, size_t length);
 	sum = s_crc32(hdr, len);
 	hdr->CRC32 = sum;
 }
@@ -256,6 +256,7 @@ EFI_STATUS efi_reboot_to_setup() {
 	status = efivar_set_uint64_le(&gEfiGlobalVariableGuid, "OsIndications", osind, flags);
 	if (EFI_ERROR(status)) return status;
 	log_info("Rebooting to EFI setup ...");
+	log_sync();
 	gRT->ResetSystem(EfiResetCold, EFI_SUCCESS, 0, NULL);
 	gBS->Stall(500000);
 	log_warning("ResetSystem returned unexpectedly");
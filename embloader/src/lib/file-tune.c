@@ -0,0 +1,282 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Guid/FileSystemInfo.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "crc32.h"
+#include "file-utils.h"
+#include "variables.h"
+#include "readable.h"
+#include "efi-utils.h"
+#include "ticks.h"
+#include "list.h"
+#include "log.h"
+
+#define TUNE_PROBE_SIZE SIZE_4MB
+#define TUNE_MIN_SIZE SIZE_16MB
+
+struct volume_chunk {
+	char *key;
+	size_t chunk;
+};
+
+struct volume_ident {
+	char *ident;
+	char *key;
+};
+
+static const size_t tune_candidates[] = {
+	SIZE_256KB, SIZE_1MB, SIZE_4MB, 0
+};
+
+static bool tune_enabled = true;
+static bool tune_persist = false;
+static list *tune_volumes = NULL;
+static list *tune_idents = NULL;
+
+/**
+ * @brief Configure the read chunk size tuner
+ *
+ * @param enabled Measure chunk sizes on the first large read of each volume
+ * @param persist Save and load the tuned chunk size from an EFI variable
+ */
+void efi_file_tune_setup(bool enabled, bool persist) {
+	tune_enabled = enabled;
+	tune_persist = persist;
+}
+
+/*
+ * Identify the volume holding a file by its label, size and block size.
+ * The info is read into a stack buffer, so a lookup does not allocate.
+ */
+static bool volume_ident_get(EFI_FILE_PROTOCOL *file, char *buff, size_t len) {
+	UINT64 data[64];
+	EFI_FILE_SYSTEM_INFO *info = (EFI_FILE_SYSTEM_INFO*) data, *alloc = NULL;
+	UINTN size = sizeof(data);
+	EFI_STATUS status;
+	status = file->GetInfo(file, &gEfiFileSystemInfoGuid, &size, info);
+	if (status == EFI_BUFFER_TOO_SMALL) {
+		status = efi_file_get_info_by(
+			file, &gEfiFileSystemInfoGuid, (VOID**)&alloc, NULL
+		);
+		info = alloc;
+	}
+	if (EFI_ERROR(status) || !info) return false;
+	snprintf(
+		buff, len, "%08X:%llx:%x",
+		s_crc32(info->VolumeLabel, StrSize(info->VolumeLabel)),
+		(unsigned long long)info->VolumeSize,
+		(unsigned)info->BlockSize
+	);
+	if (alloc) FreePool(alloc);
+	return true;
+}
+
+/* find the device path of the file system volume with this identity */
+static char *volume_device_path(const char *ident) {
+	EFI_HANDLE *handles = NULL;
+	UINTN count = 0;
+	EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *fs;
+	EFI_FILE_PROTOCOL *root;
+	char buff[64], *key = NULL;
+	if (EFI_ERROR(gBS->LocateHandleBuffer(
+		ByProtocol, &gEfiSimpleFileSystemProtocolGuid,
+		NULL, &count, &handles
+	))) return NULL;
+	for (UINTN i = 0; i < count && !key; i++) {
+		if (EFI_ERROR(gBS->HandleProtocol(
+			handles[i], &gEfiSimpleFileSystemProtocolGuid, (VOID**)&fs
+		)) || !fs) continue;
+		if (EFI_ERROR(fs->OpenVolume(fs, &root)) || !root) continue;
+		if (volume_ident_get(root, buff, sizeof(buff)) && strcmp(buff, ident) == 0)
+			key = efi_handle_to_device_path_text(handles[i]);
+		root->Close(root);
+	}
+	if (handles) FreePool(handles);
+	return key;
+}
+
+/*
+ * Get the key of the volume holding the file, the device path text of the
+ * volume. The device path is looked up once per volume, later calls only
+ * read the file system info. Volumes without a device path are keyed by
+ * their identity.
+ */
+static const char *volume_key(EFI_FILE_PROTOCOL *file) {
+	char ident[64];
+	list *p;
+	struct volume_ident vi;
+	if (!volume_ident_get(file, ident, sizeof(ident))) return NULL;
+	if ((p = list_first(tune_idents))) do {
+		LIST_DATA_DECLARE(item, p, struct volume_ident*);
+		if (item && strcmp(item->ident, ident) == 0) return item->key;
+	} while ((p = p->next));
+	vi.ident = strdup(ident);
+	if (!(vi.key = volume_device_path(ident))) vi.key = strdup(ident);
+	if (!vi.ident || !vi.key ||
+		list_obj_add_new_dup(&tune_idents, &vi, sizeof(vi)) != 0) {
+		if (vi.ident) free(vi.ident);
+		if (vi.key) free(vi.key);
+		return NULL;
+	}
+	log_debug("volume %s is %s", vi.ident, vi.key);
+	return vi.key;
+}
+
+static struct volume_chunk *volume_find(const char *key) {
+	list *p;
+	if ((p = list_first(tune_volumes))) do {
+		LIST_DATA_DECLARE(vol, p, struct volume_chunk*);
+		if (vol && strcmp(vol->key, key) == 0) return vol;
+	} while ((p = p->next));
+	return NULL;
+}
+
+static void volume_var_name(const char *key, char *name, size_t len) {
+	snprintf(name, len, "ReadChunk%08X", s_crc32((void*)key, strlen(key)));
+}
+
+static void volume_add(struct volume_chunk *vol) {
+	if (list_obj_add_new_dup(&tune_volumes, vol, sizeof(*vol)) != 0)
+		free(vol->key);
+}
+
+static bool volume_load(struct volume_chunk *vol) {
+	char name[32];
+	uint32_t value = 0;
+	if (!tune_persist) return false;
+	volume_var_name(vol->key, name, sizeof(name));
+	if (EFI_ERROR(efivar_get_uint32_le(&efivar_embloader_guid, name, &value)))
+		return false;
+	for (int i = 0; tune_candidates[i]; i++) {
+		if (tune_candidates[i] != value) continue;
+		vol->chunk = value;
+		return true;
+	}
+	return false;
+}
+
+static void volume_save(struct volume_chunk *vol) {
+	char name[32];
+	EFI_STATUS status;
+	if (!tune_persist) return;
+	volume_var_name(vol->key, name, sizeof(name));
+	status = efivar_set_uint32_le(
+		&efivar_embloader_guid, name, (uint32_t)vol->chunk,
+		EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS
+	);
+	if (EFI_ERROR(status)) log_warning(
+		"save read chunk size for volume %s failed: %s",
+		vol->key, efi_status_to_string(status)
+	);
+}
+
+/**
+ * @brief Get the read chunk size of the volume holding the file
+ *
+ * The first read larger than TUNE_MIN_SIZE on a volume probes every
+ * candidate chunk size on consecutive TUNE_PROBE_SIZE parts of the
+ * requested data, so no extra data is read, and keeps the fastest one.
+ * Probes use the same read path as the tuned reads, and the first part
+ * is read unmeasured so that cold caches do not penalize one candidate.
+ * Volumes are told apart by their device path, so the saved sizes stay
+ * with the same partition across boots.
+ * Later reads on the same volume use the remembered size directly.
+ * Without a usable timer, or when the tuner is disabled, 1MiB is used.
+ *
+ * @param file Pointer to the opened EFI_FILE_PROTOCOL
+ * @param offset Starting offset in the file
+ * @param buffer Buffer to store the read data
+ * @param size Number of bytes to read
+ * @param cb Optional callback for each finished chunk, in file order
+ * @param data User data passed to the callback
+ * @param chunk Pointer to store the chunk size to use
+ * @param probed Pointer to store the bytes already read while probing
+ * @return EFI_SUCCESS on success, error status if a probe read failed
+ */
+EFI_STATUS efi_file_tune_chunk(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	efi_file_read_cb cb,
+	void* data,
+	size_t* chunk,
+	size_t* probed
+) {
+	EFI_STATUS status;
+	const char *key;
+	char buff[64];
+	uint64_t start, used, best_speed = 0, cur;
+	struct volume_chunk *found, vol = { .chunk = SIZE_1MB };
+	*chunk = SIZE_1MB, *probed = 0;
+	if (!tune_enabled || !file || !buffer) return EFI_SUCCESS;
+	if (!(key = volume_key(file))) return EFI_SUCCESS;
+	if ((found = volume_find(key))) {
+		*chunk = found->chunk;
+		return EFI_SUCCESS;
+	}
+	if (size < TUNE_MIN_SIZE && !tune_persist) return EFI_SUCCESS;
+	if (!(vol.key = strdup(key))) return EFI_SUCCESS;
+	if (volume_load(&vol)) {
+		log_debug(
+			"use saved read chunk size %s for volume %s",
+			format_size_float(buff, vol.chunk), vol.key
+		);
+		*chunk = vol.chunk;
+		volume_add(&vol);
+		return EFI_SUCCESS;
+	}
+	if (size < TUNE_MIN_SIZE || ticks_usec() == 0) {
+		free(vol.key);
+		return EFI_SUCCESS;
+	}
+	status = efi_file_read_chunks_async(
+		file, offset, buffer, TUNE_PROBE_SIZE, SIZE_1MB, cb, data
+	);
+	if (EFI_ERROR(status)) {
+		free(vol.key);
+		return status;
+	}
+	*probed += TUNE_PROBE_SIZE;
+	for (int i = 0; tune_candidates[i]; i++) {
+		start = ticks_usec();
+		status = efi_file_read_chunks_async(
+			file, offset + *probed, (UINT8*)buffer + *probed,
+			TUNE_PROBE_SIZE, tune_candidates[i], cb, data
+		);
+		if (EFI_ERROR(status)) {
+			free(vol.key);
+			return status;
+		}
+		used = ticks_usec() - start;
+		*probed += TUNE_PROBE_SIZE;
+		if (used == 0) continue;
+		cur = (uint64_t)TUNE_PROBE_SIZE * 1000000 / used;
+		log_info(
+			"volume %s read chunk %s: %" PRIu64 ".%02u MB/s (%" PRIu64 "us)",
+			vol.key, format_size_float(buff, tune_candidates[i]),
+			cur / 1000000, (unsigned)(cur % 1000000 / 10000), used
+		);
+		if (cur > best_speed) {
+			best_speed = cur;
+			vol.chunk = tune_candidates[i];
+		}
+	}
+	log_info(
+		"use read chunk size %s for volume %s (%" PRIu64 ".%02u MB/s)",
+		format_size_float(buff, vol.chunk), vol.key,
+		best_speed / 1000000, (unsigned)(best_speed % 1000000 / 10000)
+	);
+	volume_save(&vol);
+	*chunk = vol.chunk;
+	volume_add(&vol);
+	return EFI_SUCCESS;
+}
@@ -113,38 +113,299 @@ EFI_STATUS efi_file_set_size(EFI_FILE_PROTOCOL* file, size_t size) {
 	return status;
 }
 
+#define ASYNC_READ_DEPTH 4
+
+static bool efi_file_can_async(EFI_FILE_PROTOCOL* file) {
+	EFI_TPL tpl;
+	if (file->Revision < EFI_FILE_PROTOCOL_REVISION2 || !file->ReadEx)
+		return false;
+	tpl = gBS->RaiseTPL(TPL_HIGH_LEVEL);
+	gBS->RestoreTPL(tpl);
+	return tpl == TPL_APPLICATION;
+}
+
+static EFI_STATUS efi_file_async_wait(EFI_FILE_IO_TOKEN* token, UINTN expect) {
+	UINTN index;
+	EFI_STATUS status;
+	status = gBS->WaitForEvent(1, &token->Event, &index);
+	if (EFI_ERROR(status)) return status;
+	if (EFI_ERROR(token->Status)) return token->Status;
+	if (token->BufferSize != expect) return EFI_END_OF_FILE;
+	return EFI_SUCCESS;
+}
+
 /**
- * @brief Read file data in chunks from a specific offset
+ * @brief Read file data with several overlapped ReadEx requests
  *
- * This function reads file data in chunks to avoid memory limitations.
- * It preserves the original file position after reading.
+ * ReadEx has no offset argument, so the file position is set explicitly
+ * before each request is queued. Up to ASYNC_READ_DEPTH requests are kept
+ * in flight only when the driver moves the file position as soon as a
+ * request is queued, which shows that it took the position at queue time.
+ * Otherwise every request is waited for before the next one is queued.
+ * The callback runs on each finished chunk after the next chunk has been
+ * queued, so it overlaps with the loading in both cases.
+ *
+ * @return EFI_UNSUPPORTED if the first ReadEx is rejected, so the caller
+ *         can fall back to blocking reads, or the read status
+ */
+static EFI_STATUS efi_file_async_read(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	size_t chunk,
+	efi_file_read_cb cb,
+	void* data
+) {
+	EFI_STATUS status = EFI_SUCCESS, ret;
+	EFI_FILE_IO_TOKEN tokens[ASYNC_READ_DEPTH];
+	UINTN lens[ASYNC_READ_DEPTH];
+	UINT64 pos = 0;
+	size_t queued = 0, done = 0, ready_len = 0;
+	void *ready = NULL;
+	int head = 0, count = 0, depth = ASYNC_READ_DEPTH, i;
+	memset(tokens, 0, sizeof(tokens));
+	for (i = 0; i < ASYNC_READ_DEPTH; i++) {
+		status = gBS->CreateEvent(0, 0, NULL, NULL, &tokens[i].Event);
+		if (EFI_ERROR(status)) {
+			status = EFI_UNSUPPORTED;
+			goto done;
+		}
+	}
+	for (;;) {
+		while (count < depth && queued < size) {
+			i = (head + count) % ASYNC_READ_DEPTH;
+			lens[i] = MIN(size - queued, chunk);
+			status = file->SetPosition(file, offset + queued);
+			if (EFI_ERROR(status)) goto done;
+			tokens[i].Status = EFI_NOT_READY;
+			tokens[i].Buffer = (UINT8*)buffer + queued;
+			tokens[i].BufferSize = lens[i];
+			status = file->ReadEx(file, &tokens[i]);
+			if (EFI_ERROR(status)) {
+				if (status == EFI_UNSUPPORTED && done == 0 && count == 0)
+					log_debug("ReadEx not supported, use blocking read");
+				else if (status == EFI_UNSUPPORTED)
+					status = EFI_DEVICE_ERROR;
+				goto done;
+			}
+			if (queued == 0 && (
+				EFI_ERROR(file->GetPosition(file, &pos)) ||
+				pos != offset + lens[i]
+			)) {
+				log_debug("ReadEx does not move file position when queued, serialize reads");
+				depth = 1;
+			}
+			queued += lens[i];
+			count++;
+		}
+		if (ready && cb) cb(ready, ready_len, data);
+		ready = NULL;
+		if (done >= size) break;
+		i = head;
+		status = efi_file_async_wait(&tokens[i], lens[i]);
+		head = (head + 1) % ASYNC_READ_DEPTH;
+		count--;
+		if (EFI_ERROR(status)) goto done;
+		ready = tokens[i].Buffer, ready_len = lens[i];
+		done += lens[i];
+	}
+done:
+	while (count > 0) {
+		ret = efi_file_async_wait(&tokens[head], lens[head]);
+		if (!EFI_ERROR(status) && EFI_ERROR(ret)) status = ret;
+		head = (head + 1) % ASYNC_READ_DEPTH;
+		count--;
+	}
+	for (i = 0; i < ASYNC_READ_DEPTH; i++)
+		if (tokens[i].Event) gBS->CloseEvent(tokens[i].Event);
+	return status;
+}
+
+/**
+ * @brief Read file data with blocking Read calls of a fixed chunk size
+ *
+ * The file position is moved to offset and left after the read data.
  *
  * @param file Pointer to the opened EFI_FILE_PROTOCOL
  * @param offset Starting offset in the file
  * @param buffer Buffer to store the read data
  * @param size Number of bytes to read
+ * @param chunk Maximum bytes of each Read call
+ * @param cb Optional callback for each finished chunk, in file order
+ * @param data User data passed to the callback
  * @return EFI_SUCCESS on success, error status on failure
  */
-EFI_STATUS efi_file_chunked_read(EFI_FILE_PROTOCOL* file, size_t offset, void* buffer, size_t size) {
+EFI_STATUS efi_file_read_chunks(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	size_t chunk,
+	efi_file_read_cb cb,
+	void* data
+) {
 	EFI_STATUS status;
 	UINTN read_size;
-	UINT64 read_pos = 0, old_pos = 0;
-	if (!file || !buffer) return EFI_INVALID_PARAMETER;
-	if (size == 0) return EFI_SUCCESS;
-	status = file->GetPosition(file, &old_pos);
-	if (EFI_ERROR(status)) old_pos = 0;
+	UINT64 read_pos = 0;
+	if (!file || !buffer || chunk == 0) return EFI_INVALID_PARAMETER;
 	status = file->SetPosition(file, offset);
 	if (EFI_ERROR(status)) return status;
 	while (read_pos < size) {
-		read_size = MIN(size - read_pos, SIZE_1MB);
+		read_size = MIN(size - read_pos, chunk);
 		status = file->Read(file, &read_size, (UINT8*)buffer + read_pos);
 		if (EFI_ERROR(status)) break;
 		if (read_size == 0) {
 			status = EFI_END_OF_FILE;
 			break;
 		}
+		if (cb) cb((UINT8*)buffer + read_pos, read_size, data);
 		read_pos += read_size;
 	}
+	return status;
+}
+
+/**
+ * @brief Read file data in chunks of a fixed size, overlapped when possible
+ *
+ * Uses queued ReadEx requests when the file supports them and the read
+ * spans several chunks, blocking Read calls otherwise. This is the read
+ * path of efi_file_chunked_read_ex, the chunk size tuner probes with it.
+ *
+ * @param file Pointer to the opened EFI_FILE_PROTOCOL
+ * @param offset Starting offset in the file
+ * @param buffer Buffer to store the read data
+ * @param size Number of bytes to read
+ * @param chunk Maximum bytes of each read request
+ * @param cb Optional callback for each finished chunk, in file order
+ * @param data User data passed to the callback
+ * @return EFI_SUCCESS on success, error status on failure
+ */
+EFI_STATUS efi_file_read_chunks_async(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	size_t chunk,
+	efi_file_read_cb cb,
+	void* data
+) {
+	EFI_STATUS status = EFI_UNSUPPORTED;
+	if (!file || !buffer || chunk == 0) return EFI_INVALID_PARAMETER;
+	if (size > chunk && efi_file_can_async(file))
+		status = efi_file_async_read(file, offset, buffer, size, chunk, cb, data);
+	if (status == EFI_UNSUPPORTED)
+		status = efi_file_read_chunks(file, offset, buffer, size, chunk, cb, data);
+	return status;
+}
+
+/**
+ * @brief Read file data in chunks from a specific offset
+ *
+ * This function reads file data in chunks to avoid memory limitations.
+ * It preserves the original file position after reading.
+ *
+ * @param file Pointer to the opened EFI_FILE_PROTOCOL
+ * @param offset Starting offset in the file
+ * @param buffer Buffer to store the read data
+ * @param size Number of bytes to read
+ * @return EFI_SUCCESS on success, error status on failure
+ */
+EFI_STATUS efi_file_chunked_read(EFI_FILE_PROTOCOL* file, size_t offset, void* buffer, size_t size) {
+	return efi_file_chunked_read_ex(file, offset, buffer, size, NULL, NULL);
+}
+
+/**
+ * @brief Read file data in chunks and process every finished chunk
+ *
+ * Same as efi_file_chunked_read, but when the file supports ReadEx and
+ * the read spans several chunks, the callback (for example a checksum)
+ * runs on each finished chunk while the next ones are loading.
+ * Falls back to blocking Read when ReadEx is not available.
+ * The chunk size comes from the per-volume tuner, see efi_file_tune_chunk.
+ *
+ * @param file Pointer to the opened EFI_FILE_PROTOCOL
+ * @param offset Starting offset in the file
+ * @param buffer Buffer to store the read data
+ * @param size Number of bytes to read
+ * @param cb Optional callback for each finished chunk, in file order
+ * @param data User data passed to the callback
+ * @return EFI_SUCCESS on success, error status on failure
+ */
+EFI_STATUS efi_file_chunked_read_ex(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	void* buffer,
+	size_t size,
+	efi_file_read_cb cb,
+	void* data
+) {
+	EFI_STATUS status;
+	UINT64 old_pos = 0;
+	size_t chunk = SIZE_1MB, probed = 0;
+	if (!file || !buffer) return EFI_INVALID_PARAMETER;
+	if (size == 0) return EFI_SUCCESS;
+	status = file->GetPosition(file, &old_pos);
+	if (EFI_ERROR(status)) old_pos = 0;
+	if (size > SIZE_1MB) {
+		status = efi_file_tune_chunk(
+			file, offset, buffer, size,
+			cb, data, &chunk, &probed
+		);
+		if (EFI_ERROR(status)) goto done;
+		offset += probed, size -= probed;
+		buffer = (UINT8*)buffer + probed;
+		if (size == 0) goto done;
+	}
+	status = efi_file_read_chunks_async(file, offset, buffer, size, chunk, cb, data);
+done:
+	file->SetPosition(file, old_pos);
+	return status;
+}
+
+/**
+ * @brief Stream file data through a scratch buffer
+ *
+ * Reads size bytes from offset one scratch buffer at a time and passes
+ * every finished chunk to the callback, so the data can be processed (for
+ * example checksummed) without holding the whole range in memory. Each
+ * window is split in ASYNC_READ_DEPTH chunks that are overlapped with
+ * ReadEx when the file supports it. Chunk data is only valid during the
+ * callback. The original file position is preserved.
+ *
+ * @param file Pointer to the opened EFI_FILE_PROTOCOL
+ * @param offset Starting offset in the file
+ * @param size Number of bytes to read
+ * @param scratch Scratch buffer reused for every window
+ * @param scratch_size Size of the scratch buffer
+ * @param cb Callback for each finished chunk, in file order
+ * @param data User data passed to the callback
+ * @return EFI_SUCCESS on success, error status on failure
+ */
+EFI_STATUS efi_file_stream_read(
+	EFI_FILE_PROTOCOL* file,
+	size_t offset,
+	size_t size,
+	void* scratch,
+	size_t scratch_size,
+	efi_file_read_cb cb,
+	void* data
+) {
+	EFI_STATUS status = EFI_SUCCESS;
+	UINT64 old_pos = 0;
+	size_t len, chunk;
+	if (!file || !scratch || scratch_size == 0 || !cb)
+		return EFI_INVALID_PARAMETER;
+	chunk = MAX(scratch_size / ASYNC_READ_DEPTH, 1);
+	if (EFI_ERROR(file->GetPosition(file, &old_pos))) old_pos = 0;
+	while (size > 0) {
+		len = MIN(size, scratch_size);
+		status = efi_file_read_chunks_async(
+			file, offset, scratch, len, chunk, cb, data
+		);
+		if (EFI_ERROR(status)) break;
+		offset += len, size -= len;
+	}
 	file->SetPosition(file, old_pos);
 	return status;
 }
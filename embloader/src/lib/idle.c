@@ -0,0 +1,66 @@
+#include <Library/UefiBootServicesTableLib.h>
+#include "efi-utils.h"
+#include "ticks.h"
+
+static efi_idle_handler idle_handler = NULL;
+static void *idle_data = NULL;
+
+/**
+ * @brief Set the handler called while waiting in efi_idle_stall
+ *
+ * The handler runs one small slice of background work per call and
+ * returns true while it still has more work to do.
+ * Only one handler can be installed, pass NULL to remove it.
+ *
+ * @param handler Handler function, or NULL to remove the current one
+ * @param data User data passed to the handler
+ */
+void efi_set_idle_handler(efi_idle_handler handler, void *data) {
+	idle_handler = handler;
+	idle_data = handler ? data : NULL;
+}
+
+/**
+ * @brief Wait for the specified time and run idle work meanwhile
+ *
+ * Same as gBS->Stall when no idle handler is installed. Otherwise a
+ * relative timer event bounds the wait, and the idle handler is called
+ * repeatedly until the timer fires. When the handler has nothing left to
+ * do, the rest of the time is spent waiting for the timer event.
+ * A handler slice that is still running when the timer fires makes the
+ * wait longer than requested, so callers that keep a clock should advance
+ * it by the returned time instead of usec.
+ *
+ * @param usec Time to wait in microseconds
+ * @return Time actually spent in microseconds, at least usec
+ */
+UINTN efi_idle_stall(UINTN usec) {
+	UINTN index;
+	uint64_t start, used;
+	EFI_EVENT timer = NULL;
+	if (!idle_handler || usec == 0) {
+		gBS->Stall(usec);
+		return usec;
+	}
+	start = ticks_usec();
+	if (EFI_ERROR(gBS->CreateEvent(EVT_TIMER, 0, NULL, NULL, &timer))) {
+		gBS->Stall(usec);
+		return usec;
+	}
+	if (EFI_ERROR(gBS->SetTimer(
+		timer, TimerRelative,
+		EFI_TIMER_PERIOD_MICROSECONDS(usec)
+	))) {
+		gBS->CloseEvent(timer);
+		gBS->Stall(usec);
+		return usec;
+	}
+	while (gBS->CheckEvent(timer) == EFI_NOT_READY) {
+		if (idle_handler && idle_handler(idle_data)) continue;
+		gBS->WaitForEvent(1, &timer, &index);
+		break;
+	}
+	gBS->CloseEvent(timer);
+	if (start == 0 || (used = ticks_usec() - start) < usec) return usec;
+	return (UINTN) used;
+}
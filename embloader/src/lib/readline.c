@@ -219,8 +219,7 @@ EFI_STATUS efi_readline(
 	bool esc_pending = false;
 	while (true) {
 		memset(&key, 0, sizeof(key));
-		gBS->Stall(50000);
-		times += 50;
+		times += efi_idle_stall(50000) / 1000;
 		status = in->ReadKeyStroke(in, &key);
 		if (status == EFI_NOT_READY) {
 			if (esc_pending) {
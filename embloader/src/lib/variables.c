@@ -11,6 +11,11 @@
 #include "encode.h"
 #include "variables.h"
 
+const EFI_GUID efivar_embloader_guid = {
+	0x29384912, 0xF33F, 0x470E,
+	{ 0xAA, 0x08, 0x4C, 0x21, 0x79, 0x22, 0x0A, 0x40 }
+};
+
 EFI_STATUS efivar_set_raw(
 	const EFI_GUID *vendor,
 	const char *name,
@@ -20,12 +20,17 @@ EFI_STATUS linux_boot_use_efi(linux_data *data) {
 		status = embloader_prepare_boot();
 		if (EFI_ERROR(status)) return status;
 	}
-	if (data->initramfs && data->initramfs_size > 0) {
-		status = linux_initramfs_register(
+	if (data->initramfs_size > 0 && (data->initramfs || data->initramfs_files)) {
+		if (data->initramfs) status = linux_initramfs_register(
 			data->initramfs,
 			data->initramfs_size,
 			&initrd_hand
 		);
+		else status = linux_initramfs_register_files(
+			data->initramfs_files,
+			data->initramfs_size,
+			&initrd_hand
+		);
 		if (EFI_ERROR(status)) {
 			log_error(
 				"register initramfs failed: %s",
@@ -34,7 +39,17 @@ EFI_STATUS linux_boot_use_efi(linux_data *data) {
 			return status;
 		}
 	}
-	status = linux_boot_efi(data->kernel, data->kernel_size, data->bootargs);
+	if (data->kernel_path) status = linux_boot_efi_path(
+		data->kernel_path, data->bootargs
+	);
+	else if (!data->kernel || data->kernel_size == 0)
+		status = EFI_INVALID_PARAMETER;
+	else {
+		status = linux_boot_efi_staged(
+			data->kernel, data->kernel_size, data->bootargs
+		);
+		data->kernel = NULL;
+	}
 	if (initrd_hand) linux_initramfs_unregister(initrd_hand);
 	if (EFI_ERROR(status)) {
 		log_error("boot kernel failed: %s", efi_status_to_string(status));
@@ -16,9 +16,13 @@ linux_bootinfo* linux_bootinfo_parse(confignode *node) {
 	if (!info) return NULL;
 	memset(info, 0, sizeof(linux_bootinfo));
 	info->kernel = confignode_path_get_string(node, "kernel", NULL, NULL);
+	info->kernel_direct = confignode_path_get_bool(node, "kernel-direct", false, NULL);
 	if ((q = confignode_path_get_string_or_list_to_list(
 		node, "initramfs", NULL
 	))) list_obj_add(&info->initramfs, q);
+	info->initramfs_stream = confignode_path_get_bool(
+		node, "initramfs-stream", false, NULL
+	);
 	if ((q = confignode_path_get_string_or_list_to_list(
 		node, "bootargs", NULL
 	))) list_obj_add(&info->bootargs, q);
@@ -19,7 +19,7 @@
  * @return enum embloader_dtbo_on_error The configured behavior for DTBO application errors
  */
 enum embloader_dtbo_on_error linux_get_dtbo_on_error() {
-	char *value = confignode_path_get_string(
+	const char *value = confignode_path_get_cstr(
 		g_embloader.config,
 		"devicetree.dtbo-on-error", "ignore", NULL
 	);
@@ -34,7 +34,6 @@ enum embloader_dtbo_on_error linux_get_dtbo_on_error() {
 		else if (strcasecmp(value, "revert") == 0)
 			result = DTBO_ERROR_REVERT;
 		else log_warning("unknown dtbo-on-error value %s", value);
-		free(value);
 	}
 	return result;
 }
@@ -48,13 +47,11 @@ enum embloader_dtbo_on_error linux_get_dtbo_on_error() {
  * @return list* List of resolved DTBO directory paths, or NULL if no DTBO directory configured
  */
 list* embloader_dt_get_dtbo_dir() {
-	char *dtbo_dir = confignode_path_get_string(
+	const char *dtbo_dir = confignode_path_get_cstr(
 		g_embloader.config, "devicetree.dtbo-dir", NULL, NULL
 	);
 	if (!dtbo_dir) return NULL;
-	list *ret = embloader_resolve_path(dtbo_dir);
-	free(dtbo_dir);
-	return ret;
+	return embloader_resolve_path(dtbo_dir);
 }
 
 static bool apply_dtbo_libufdt(const char *dtbo_name, fdt base, fdt dtbo) {
@@ -118,9 +115,11 @@ static bool apply_dtbo_libfdt(const char *dtbo_name, fdt base, fdt dtbo) {
  */
 bool linux_apply_dtbo(const char *dtbo_name, fdt base, fdt dtbo) {
 	bool result = false;
-	char *method = confignode_path_get_string(
-		g_embloader.config,
-		"devicetree.dtbo-method", "libufdt", NULL
+	static confignode_path *method_path = NULL;
+	if (!method_path) method_path = confignode_path_compile("devicetree.dtbo-method");
+	const char *method = confignode_value_get_cstr(
+		confignode_path_resolve(g_embloader.config, method_path),
+		"libufdt", NULL
 	);
 	if (!method) return false;
 	if (strcasecmp(method, "libufdt") == 0)
@@ -128,7 +127,6 @@ bool linux_apply_dtbo(const char *dtbo_name, fdt base, fdt dtbo) {
 	else if (strcasecmp(method, "libfdt") == 0)
 		result = apply_dtbo_libfdt(dtbo_name, base, dtbo);
 	else log_warning("unknown dtbo method %s", method);
-	free(method);
 	return result;
 }
 
@@ -2,7 +2,9 @@
 #include <Library/UefiLib.h>
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include "linuxboot.h"
+#include "efi-utils.h"
 
 static const union memmap_dp {
 	struct {
@@ -30,6 +32,14 @@ static const union memmap_dp {
 	}
 };
 
+static EFI_STATUS linux_boot_efi_mem(void *img, size_t len, const char *cmdline, bool staged) {
+	union memmap_dp dp = memmap_dp_def;
+	if (!img || len == 0) return EFI_INVALID_PARAMETER;
+	dp.memmap.StartingAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)img;
+	dp.memmap.EndingAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)img + len;
+	return embloader_start_efi_ex(&dp.dp, img, len, cmdline, staged);
+}
+
 /**
  * @brief Boot Linux kernel using EFI stub
  *
@@ -42,9 +52,45 @@ static const union memmap_dp {
  * @return EFI_STATUS no returns on successful boot, or appropriate error code on failure
  */
 EFI_STATUS linux_boot_efi(void *img, size_t len, const char *cmdline) {
-	union memmap_dp dp = memmap_dp_def;
-	if (!img || len == 0) return EFI_INVALID_PARAMETER;
-	dp.memmap.StartingAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)img;
-	dp.memmap.EndingAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)img + len;
-	return embloader_start_efi(&dp.dp, img, len, cmdline);
+	return linux_boot_efi_mem(img, len, cmdline, false);
+}
+
+/**
+ * @brief Boot Linux kernel using EFI stub from staging pages
+ *
+ * Same as linux_boot_efi, but the image pages are owned by this function,
+ * they are freed right after LoadImage, before the kernel is started.
+ * A NULL img or zero len is rejected without taking the pages, so the
+ * caller keeps ownership and must free them.
+ *
+ * @param img Pointer to the kernel image allocated by AllocatePages
+ * @param len Size of the kernel image in bytes
+ * @param cmdline Kernel command line arguments (can be NULL)
+ * @return EFI_STATUS no returns on successful boot, or appropriate error code on failure
+ */
+EFI_STATUS linux_boot_efi_staged(void *img, size_t len, const char *cmdline) {
+	return linux_boot_efi_mem(img, len, cmdline, true);
+}
+
+/**
+ * @brief Boot Linux kernel using EFI stub directly from file
+ *
+ * This function boots a Linux kernel image through a file path device path
+ * in the embloader volume, so the firmware reads the image by itself and
+ * no staging copy is made by embloader.
+ *
+ * @param path Path of the kernel image in the embloader volume
+ * @param cmdline Kernel command line arguments (can be NULL)
+ * @return EFI_STATUS no returns on successful boot, or appropriate error code on failure
+ */
+EFI_STATUS linux_boot_efi_path(const char *path, const char *cmdline) {
+	EFI_STATUS status;
+	EFI_DEVICE_PATH_PROTOCOL *dp;
+	if (!path) return EFI_INVALID_PARAMETER;
+	if (!g_embloader.dir.dp) return EFI_NOT_READY;
+	dp = efi_device_path_append_filepath(g_embloader.dir.dp, path);
+	if (!dp) return EFI_OUT_OF_RESOURCES;
+	status = embloader_start_efi(dp, NULL, 0, cmdline);
+	FreePool(dp);
+	return status;
 }
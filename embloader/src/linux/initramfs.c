@@ -8,6 +8,7 @@
 #include "efi-utils.h"
 #include "file-utils.h"
 #include "readable.h"
+#include "ticks.h"
 #include "log.h"
 
 #define LINUX_INITRD_MEDIA_GUID \
@@ -16,6 +17,7 @@
 struct initrd_loader {
 	EFI_LOAD_FILE2_PROTOCOL load;
 	const void *address;
+	list *files;
 	size_t length;
 };
 
@@ -38,6 +40,29 @@ static const struct {
 	}
 };
 
+static EFI_STATUS initrd_read_files(struct initrd_loader *loader, void *buffer) {
+	EFI_STATUS status;
+	size_t offset = 0;
+	list *p;
+	if ((p = list_first(loader->files))) do {
+		LIST_DATA_DECLARE(file, p, linux_initramfs_file*);
+		if (!file || !file->file || file->size == 0) continue;
+		if (offset + file->size > loader->length) return EFI_BAD_BUFFER_SIZE;
+		status = efi_file_chunked_read(file->file, 0, buffer + offset, file->size);
+		if (EFI_ERROR(status)) {
+			log_error(
+				"stream initramfs %s failed: %s",
+				file->name, efi_status_to_string(status)
+			);
+			return status;
+		}
+		offset += file->size;
+	} while ((p = p->next));
+	if (offset != loader->length) return EFI_BAD_BUFFER_SIZE;
+	log_info("streamed %" PRIu64 " bytes initramfs to %p", (uint64_t)offset, buffer);
+	return EFI_SUCCESS;
+}
+
 static EFIAPI EFI_STATUS initrd_load_file(
 	EFI_LOAD_FILE2_PROTOCOL *this,
 	EFI_DEVICE_PATH *path,
@@ -49,16 +74,36 @@ static EFIAPI EFI_STATUS initrd_load_file(
 	if (!this || !size || !path) return EFI_INVALID_PARAMETER;
 	if (policy) return EFI_UNSUPPORTED;
 	loader = BASE_CR(this, struct initrd_loader, load);
-	if (loader->length == 0 || !loader->address) return EFI_NOT_FOUND;
+	if (loader->length == 0) return EFI_NOT_FOUND;
+	if (!loader->address && !loader->files) return EFI_NOT_FOUND;
 	if (!buffer || *size < loader->length) {
 		*size = loader->length;
 		return EFI_BUFFER_TOO_SMALL;
 	}
-	memcpy(buffer, loader->address, loader->length);
+	if (loader->address) memcpy(buffer, loader->address, loader->length);
+	else {
+		EFI_STATUS status = initrd_read_files(loader, buffer);
+		if (EFI_ERROR(status)) return status;
+	}
 	*size = loader->length;
 	return EFI_SUCCESS;
 }
 
+static EFI_STATUS initrd_install(struct initrd_loader *loader, EFI_HANDLE *hand) {
+	EFI_STATUS status;
+	EFI_DEVICE_PATH *dp = (EFI_DEVICE_PATH *) &initrd_dp;
+	EFI_HANDLE handle;
+	status = gBS->LocateDevicePath(&gEfiLoadFile2ProtocolGuid, &dp, &handle);
+	if (status != EFI_NOT_FOUND) return EFI_ALREADY_STARTED;
+	loader->load.LoadFile = initrd_load_file;
+	return gBS->InstallMultipleProtocolInterfaces(
+		hand,
+		&gEfiDevicePathProtocolGuid, &initrd_dp,
+		&gEfiLoadFile2ProtocolGuid, loader,
+		NULL
+	);
+}
+
 /**
  * @brief Register initramfs as EFI LoadFile2 protocol
  *
@@ -72,23 +117,41 @@ static EFIAPI EFI_STATUS initrd_load_file(
  */
 EFI_STATUS linux_initramfs_register(const void *ptr, size_t size, EFI_HANDLE *hand) {
 	EFI_STATUS status;
-	EFI_DEVICE_PATH *dp = (EFI_DEVICE_PATH *) &initrd_dp;
-	EFI_HANDLE handle;
 	struct initrd_loader *loader;
 	if (!ptr || size == 0) return EFI_INVALID_PARAMETER;
-	status = gBS->LocateDevicePath(&gEfiLoadFile2ProtocolGuid, &dp, &handle);
-	if (status != EFI_NOT_FOUND) return EFI_ALREADY_STARTED;
 	loader = malloc(sizeof(struct initrd_loader));
 	if (!loader) return EFI_OUT_OF_RESOURCES;
-	loader->load.LoadFile = initrd_load_file;
+	memset(loader, 0, sizeof(struct initrd_loader));
 	loader->address = ptr;
 	loader->length = size;
-	status = gBS->InstallMultipleProtocolInterfaces(
-		hand,
-		&gEfiDevicePathProtocolGuid, &initrd_dp,
-		&gEfiLoadFile2ProtocolGuid, loader,
-		NULL
-	);
+	status = initrd_install(loader, hand);
+	if (EFI_ERROR(status)) free(loader);
+	return status;
+}
+
+/**
+ * @brief Register opened initramfs files as EFI LoadFile2 protocol
+ *
+ * This function registers a list of opened initramfs files as an EFI
+ * LoadFile2 protocol. Nothing is preloaded, when the Linux kernel calls
+ * LoadFile2, every file is read directly into the kernel supplied buffer.
+ * The file list must stay valid until the handle is unregistered.
+ *
+ * @param files List of linux_initramfs_file with opened file handles
+ * @param size Total size of all initramfs files in bytes
+ * @param hand Pointer to store the created EFI handle
+ * @return EFI_STATUS Returns EFI_SUCCESS on success, or appropriate error code on failure
+ */
+EFI_STATUS linux_initramfs_register_files(list *files, size_t size, EFI_HANDLE *hand) {
+	EFI_STATUS status;
+	struct initrd_loader *loader;
+	if (!files || size == 0) return EFI_INVALID_PARAMETER;
+	loader = malloc(sizeof(struct initrd_loader));
+	if (!loader) return EFI_OUT_OF_RESOURCES;
+	memset(loader, 0, sizeof(struct initrd_loader));
+	loader->files = files;
+	loader->length = size;
+	status = initrd_install(loader, hand);
 	if (EFI_ERROR(status)) free(loader);
 	return status;
 }
@@ -121,102 +184,193 @@ EFI_STATUS linux_initramfs_unregister(EFI_HANDLE hand) {
 	return EFI_SUCCESS;
 }
 
-struct initramfs_file {
-	char *name;
-	void *data;
-	size_t size;
-};
-
 static int free_initramfs_file(void *p) {
-	struct initramfs_file *f = (struct initramfs_file*)p;
+	linux_initramfs_file *f = (linux_initramfs_file*)p;
 	if (!f) return -EINVAL;
 	if (f->name) free(f->name);
-	if (f->data) FreePages(f->data, EFI_SIZE_TO_PAGES(f->size));
+	if (f->file) f->file->Close(f->file);
 	memset(f, 0, sizeof(*f));
 	free(f);
 	return 0;
 }
 
 /**
- * @brief Load initramfs files for Linux boot
+ * @brief Close and free a list of opened initramfs files
  *
- * This function loads and combines multiple initramfs files into a single
- * initramfs archive for Linux kernel boot.
+ * @param files List of linux_initramfs_file to free (may be NULL)
+ */
+void linux_initramfs_files_free(list *files) {
+	if (files) list_free_all(files, free_initramfs_file);
+}
+
+/**
+ * @brief Open all initramfs files and collect their sizes
+ *
+ * This is the first pass of the initramfs loader, it only opens every
+ * listed file and queries the size, no file content is read here.
  *
- * @param data Pointer to linux_data structure to store the combined initramfs
  * @param info Pointer to linux_bootinfo structure containing initramfs file list
+ * @param files Pointer to store the list of opened linux_initramfs_file
+ * @param total Pointer to store the total size of all initramfs files
  * @return EFI_STATUS Returns EFI_SUCCESS on success, or appropriate error code on failure
  */
-EFI_STATUS linux_load_initramfs(linux_data *data, linux_bootinfo *info) {
+EFI_STATUS linux_initramfs_open(linux_bootinfo *info, list **files, size_t *total) {
 	EFI_STATUS status;
 	char buff[64];
-	void *ptr = NULL, *pages = NULL;
-	size_t len = 0, pcnt = 0, total_len = 0;
-	list *ptrs = NULL, *p;
-	if (!data || !info) return EFI_INVALID_PARAMETER;
+	list *p;
+	*files = NULL, *total = 0;
 	if ((p = list_first(info->initramfs))) do {
 		LIST_DATA_DECLARE(initramfs, p, char*);
 		if (!initramfs) continue;
-		ptr = NULL, len = 0;
-		log_info("loading initramfs %s", initramfs);
-		status = efi_file_open_read_pages(
-			info->root, initramfs, &ptr, &len
+		linux_initramfs_file file = {};
+		status = efi_open(
+			info->root, &file.file, initramfs,
+			EFI_FILE_MODE_READ, 0
 		);
+		if (!EFI_ERROR(status) && !file.file) status = EFI_NOT_FOUND;
+		if (!EFI_ERROR(status))
+			status = efi_file_get_size(file.file, &file.size);
 		if (EFI_ERROR(status)) {
 			log_error(
-				"load initramfs %s failed: %s",
+				"open initramfs %s failed: %s",
 				initramfs, efi_status_to_string(status)
 			);
-			goto fail;
+			if (file.file) file.file->Close(file.file);
+			return status;
 		}
-		log_info(
-			"loaded initramfs %s size %s (%" PRIu64 " bytes)",
-			initramfs, format_size_float(buff, len), (uint64_t)len
+		if (file.size == 0) {
+			log_warning("skip empty initramfs %s", initramfs);
+			file.file->Close(file.file);
+			continue;
+		}
+		log_debug(
+			"found initramfs %s size %s (%" PRIu64 " bytes)",
+			initramfs, format_size_float(buff, file.size),
+			(uint64_t)file.size
 		);
-		struct initramfs_file file = {
-			.name = strdup(initramfs),
-			.data = ptr, .size = len,
-		};
-		list_obj_add_new_dup(&ptrs, &file, sizeof(file));
-		total_len += len, ptr = NULL, len = 0;
+		file.name = strdup(initramfs);
+		if (!file.name || list_obj_add_new_dup(files, &file, sizeof(file)) != 0) {
+			if (file.name) free(file.name);
+			file.file->Close(file.file);
+			return EFI_OUT_OF_RESOURCES;
+		}
+		*total += file.size;
 	} while ((p = p->next));
-	if (!ptrs) {
+	return EFI_SUCCESS;
+}
+
+/**
+ * @brief Allocate pages below 4GiB for combined initramfs
+ *
+ * @param size Total size of all initramfs files
+ * @param pages Pointer to store the allocated pages
+ * @return EFI_STATUS Returns EFI_SUCCESS on success, or appropriate error code on failure
+ */
+EFI_STATUS linux_initramfs_alloc(size_t size, void **pages) {
+	EFI_STATUS status;
+	EFI_PHYSICAL_ADDRESS addr = UINT32_MAX;
+	if (!pages || size == 0) return EFI_INVALID_PARAMETER;
+	*pages = NULL;
+	status = gBS->AllocatePages(
+		AllocateMaxAddress, EfiLoaderData,
+		EFI_SIZE_TO_PAGES(size), &addr
+	);
+	if (EFI_ERROR(status)) {
+		log_error(
+			"alloc pages for initramfs failed: %s",
+			efi_status_to_string(status)
+		);
+		return status;
+	}
+	*pages = (void*)(UINTN)addr;
+	return EFI_SUCCESS;
+}
+
+/**
+ * @brief Load initramfs files for Linux boot
+ *
+ * This function loads and combines multiple initramfs files into a single
+ * initramfs archive for Linux kernel boot. It works in two passes: the
+ * first pass opens all files to get the total size, then one allocation
+ * below 4GiB is made and every file is read straight to its offset.
+ * In stream mode the second pass is skipped, the opened files are kept in
+ * linux_data and read by the LoadFile2 provider when the kernel asks.
+ *
+ * @param data Pointer to linux_data structure to store the combined initramfs
+ * @param info Pointer to linux_bootinfo structure containing initramfs file list
+ * @return EFI_STATUS Returns EFI_SUCCESS on success, or appropriate error code on failure
+ */
+EFI_STATUS linux_load_initramfs(linux_data *data, linux_bootinfo *info) {
+	EFI_STATUS status;
+	char buff[64], speed[64];
+	void *pages = NULL;
+	size_t pcnt = 0, total_len = 0, offset = 0;
+	uint64_t start, used;
+	int cnt = 0;
+	list *files = NULL, *p;
+	if (!data || !info) return EFI_INVALID_PARAMETER;
+	status = linux_initramfs_open(info, &files, &total_len);
+	if (EFI_ERROR(status)) goto fail;
+	if (!files) {
 		log_debug("no initramfs loaded");
 		return EFI_SUCCESS;
 	}
+	if (info->initramfs_stream) {
+		data->initramfs_files = files;
+		data->initramfs_size = total_len;
+		log_info(
+			"streaming %d initramfs size %s (%" PRIu64 " bytes)",
+			list_count(files),
+			format_size_float(buff, total_len),
+			(uint64_t)total_len
+		);
+		return EFI_SUCCESS;
+	}
 	log_info(
-		"loaded %d initramfs size %s (%" PRIu64 " bytes)",
-		list_count(ptrs),
+		"loading %d initramfs size %s (%" PRIu64 " bytes)",
+		list_count(files),
 		format_size_float(buff, total_len),
 		(uint64_t)total_len
 	);
-	pages = (void*) UINT32_MAX;
 	pcnt = EFI_SIZE_TO_PAGES(total_len);
-	status = gBS->AllocatePages(
-		AllocateMaxAddress, EfiLoaderData,
-		pcnt, (EFI_PHYSICAL_ADDRESS*)&pages
-	);
+	status = linux_initramfs_alloc(total_len, &pages);
 	if (EFI_ERROR(status)) {
-		pages = NULL, pcnt = 0;
-		log_error(
-			"alloc pages for initramfs %s failed: %s",
-			info->initramfs, efi_status_to_string(status)
-		);
+		pcnt = 0;
 		goto fail;
 	}
-	int cnt = 0;
-	size_t offset = 0;
-	if ((p = list_first(ptrs))) do {
-		LIST_DATA_DECLARE(file, p, struct initramfs_file*);
-		if (!file || !file->data || file->size == 0) continue;
+	if ((p = list_first(files))) do {
+		LIST_DATA_DECLARE(file, p, linux_initramfs_file*);
+		if (!file || !file->file || file->size == 0) continue;
 		if (offset + file->size > total_len) {
 			log_error("initramfs %s size overflow at %" PRIu64, file->name, offset);
+			status = EFI_BAD_BUFFER_SIZE;
+			goto fail;
+		}
+		log_info("loading initramfs %s", file->name);
+		start = ticks_usec();
+		status = efi_file_chunked_read(file->file, 0, pages + offset, file->size);
+		if (EFI_ERROR(status)) {
+			log_error(
+				"load initramfs %s failed: %s",
+				file->name, efi_status_to_string(status)
+			);
 			goto fail;
 		}
-		memcpy(pages + offset, file->data, file->size);
+		used = ticks_usec() - start;
+		if (start > 0 && used > 0) format_size_float_ex(
+			speed, sizeof(speed),
+			(uint64_t)file->size * 1000000 / used,
+			size_units_ibs, 1024, 2
+		);
+		else strcpy(speed, "unknown");
+		log_info(
+			"loaded initramfs %s size %s (%" PRIu64 " bytes) at %s",
+			file->name, format_size_float(buff, file->size),
+			(uint64_t)file->size, speed
+		);
 		offset += file->size, cnt++;
 	} while ((p = p->next));
-	list_free_all(ptrs, free_initramfs_file);
+	linux_initramfs_files_free(files);
 	data->initramfs = pages;
 	data->initramfs_size = total_len;
 	log_info(
@@ -226,6 +380,6 @@ EFI_STATUS linux_load_initramfs(linux_data *data, linux_bootinfo *info) {
 	return EFI_SUCCESS;
 fail:
 	if (pages) gBS->FreePages((UINTN)pages, pcnt);
-	list_free_all(ptrs, free_initramfs_file);
+	linux_initramfs_files_free(files);
 	return status;
 }
@@ -6,11 +6,64 @@
 #include "readable.h"
 #include "log.h"
 
+/**
+ * @brief Check whether the kernel will be loaded by firmware from file
+ *
+ * @param info Pointer to linux_bootinfo structure containing kernel file path
+ * @return true if kernel-direct is enabled and usable for this kernel
+ */
+bool linux_kernel_is_direct(linux_bootinfo *info) {
+	return info && info->kernel && info->kernel_direct &&
+		g_embloader.dir.dp && info->root == g_embloader.dir.root;
+}
+
+/**
+ * @brief Prepare Linux kernel image for direct boot from file
+ *
+ * Only checks that the kernel exists and records its path and size,
+ * the image will be read by firmware LoadImage from the file device path,
+ * this avoids a staging copy of the whole kernel in memory.
+ *
+ * @param data Pointer to linux_data structure to store the kernel path
+ * @param info Pointer to linux_bootinfo structure containing kernel file path
+ * @return EFI_STATUS Returns EFI_SUCCESS on success, or appropriate error code on failure
+ */
+static EFI_STATUS linux_load_kernel_direct(linux_data *data, linux_bootinfo *info) {
+	EFI_STATUS status;
+	char buff[64];
+	size_t len = 0;
+	EFI_FILE_PROTOCOL *file = NULL;
+	status = efi_open(info->root, &file, info->kernel, EFI_FILE_MODE_READ, 0);
+	if (!EFI_ERROR(status) && !file) status = EFI_NOT_FOUND;
+	if (!EFI_ERROR(status)) status = efi_file_get_size(file, &len);
+	if (file) file->Close(file);
+	if (!EFI_ERROR(status) && len == 0) status = EFI_END_OF_FILE;
+	if (EFI_ERROR(status)) {
+		log_error(
+			"open kernel %s failed: %s",
+			info->kernel, efi_status_to_string(status)
+		);
+		return status;
+	}
+	if (!(data->kernel_path = strdup(info->kernel)))
+		return EFI_OUT_OF_RESOURCES;
+	data->kernel_size = len;
+	log_info(
+		"kernel %s size %s (%" PRIu64 " bytes) will be loaded by firmware",
+		info->kernel,
+		format_size_float(buff, len),
+		(uint64_t)len
+	);
+	return EFI_SUCCESS;
+}
+
 /**
  * @brief Load Linux kernel image from file
  *
  * This function loads a Linux kernel image from the specified file path,
  * allocates appropriate memory pages, and prepares it for execution.
+ * When kernel-direct is enabled and the kernel lives in the embloader
+ * volume, only the path is recorded and the image is not read here.
  *
  * @param data Pointer to linux_data structure to store the loaded kernel
  * @param info Pointer to linux_bootinfo structure containing kernel file path
@@ -23,6 +76,8 @@ EFI_STATUS linux_load_kernel(linux_data *data, linux_bootinfo *info) {
 	size_t len = 0;
 	if (!data || !info || !info->kernel)
 		return EFI_INVALID_PARAMETER;
+	if (linux_kernel_is_direct(info))
+		return linux_load_kernel_direct(data, info);
 	log_info("loading kernel %s", info->kernel);
 	status = efi_file_open_read_pages(
 		info->root, info->kernel, &ptr, &len
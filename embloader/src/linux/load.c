@@ -23,28 +23,49 @@ linux_data* linux_data_load(linux_bootinfo *info) {
 	memset(data, 0, sizeof(linux_data));
 	if (EFI_ERROR(linux_load_kernel(data, info))) goto fail;
 	if (EFI_ERROR(linux_load_initramfs(data, info))) goto fail;
-	if (EFI_ERROR(linux_load_bootargs(data, info))) goto fail;
 	if (EFI_ERROR(linux_load_devicetree(data, info))) goto fail;
-	if (EFI_ERROR(linux_load_dtoverlay(data, info))) {
+	if (EFI_ERROR(linux_data_finish(data, info))) goto fail;
+	return data;
+fail:
+	linux_data_clean(data);
+	return NULL;
+}
+
+/**
+ * @brief Finish Linux boot data after files are loaded
+ *
+ * This function prepares boot arguments and applies device tree overlays,
+ * it runs after kernel, initramfs and device tree are loaded, either by
+ * linux_data_load or by a finished prefetch.
+ *
+ * @param data Pointer to linux_data structure with loaded files
+ * @param info Pointer to linux_bootinfo structure containing boot configuration
+ * @return EFI_STATUS Returns EFI_SUCCESS on success, or appropriate error code on failure
+ */
+EFI_STATUS linux_data_finish(linux_data *data, linux_bootinfo *info) {
+	EFI_STATUS status;
+	if (!data || !info) return EFI_INVALID_PARAMETER;
+	status = linux_load_bootargs(data, info);
+	if (EFI_ERROR(status)) return status;
+	status = linux_load_dtoverlay(data, info);
+	if (EFI_ERROR(status)) {
 		if (confignode_path_get_bool(
 			g_embloader.config,
 			"devicetree.skip-overlays-error",
 			true, NULL
-		)) goto fail;
+		)) return status;
 		log_warning("continue boot without applying dtbo");
 	}
 	log_debug("linux boot data prepared");
-	return data;
-fail:
-	linux_data_clean(data);
-	return NULL;
+	return EFI_SUCCESS;
 }
 
 /**
  * @brief Clean up and free a linux_data structure
  *
  * This function frees all allocated memory within a linux_data structure
- * including kernel pages, initramfs pages, boot arguments, and device tree.
+ * including kernel pages, initramfs pages or opened initramfs files, boot
+ * arguments, and device tree.
  *
  * @param data Pointer to linux_data structure to be cleaned up
  */
@@ -58,8 +79,10 @@ void linux_data_clean(linux_data *data) {
 		(UINTN) data->initramfs,
 		EFI_SIZE_TO_PAGES(ALIGN_VALUE(data->initramfs_size, EFI_PAGE_SIZE))
 	);
+	linux_initramfs_files_free(data->initramfs_files);
 	if (data->fdt) free(data->fdt);
 	if (data->bootargs) free(data->bootargs);
+	if (data->kernel_path) free(data->kernel_path);
 	memset(data, 0, sizeof(linux_data));
 	free(data);
 }
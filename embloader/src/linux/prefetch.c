@@ -0,0 +1,256 @@
+#include <Library/BaseLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <inttypes.h>
+#include "linuxboot.h"
+#include "efi-utils.h"
+#include "file-utils.h"
+#include "readable.h"
+#include "ticks.h"
+#include "log.h"
+
+enum linux_prefetch_stage {
+	PREFETCH_KERNEL,
+	PREFETCH_KERNEL_READ,
+	PREFETCH_INITRAMFS,
+	PREFETCH_INITRAMFS_READ,
+	PREFETCH_DEVICETREE,
+	PREFETCH_DONE,
+	PREFETCH_FAILED,
+};
+
+struct linux_prefetch {
+	linux_bootinfo *info;
+	linux_data *data;
+	enum linux_prefetch_stage stage;
+	EFI_STATUS status;
+	EFI_FILE_PROTOCOL *kernel;
+	list *files;
+	list *current;
+	size_t offset;
+	size_t pos;
+	uint64_t start;
+};
+
+static EFI_STATUS prefetch_kernel(linux_prefetch *pf) {
+	EFI_STATUS status;
+	size_t len = 0;
+	linux_bootinfo *info = pf->info;
+	if (linux_kernel_is_direct(info)) {
+		status = linux_load_kernel(pf->data, info);
+		if (!EFI_ERROR(status)) pf->stage = PREFETCH_INITRAMFS;
+		return status;
+	}
+	status = efi_open(info->root, &pf->kernel, info->kernel, EFI_FILE_MODE_READ, 0);
+	if (!EFI_ERROR(status) && !pf->kernel) status = EFI_NOT_FOUND;
+	if (!EFI_ERROR(status)) status = efi_file_get_size(pf->kernel, &len);
+	if (!EFI_ERROR(status) && len == 0) status = EFI_END_OF_FILE;
+	if (!EFI_ERROR(status) && !(pf->data->kernel = AllocatePages(EFI_SIZE_TO_PAGES(len))))
+		status = EFI_OUT_OF_RESOURCES;
+	if (EFI_ERROR(status)) {
+		log_warning(
+			"prefetch kernel %s failed: %s",
+			info->kernel, efi_status_to_string(status)
+		);
+		return status;
+	}
+	pf->data->kernel_size = len;
+	pf->offset = 0;
+	pf->stage = PREFETCH_KERNEL_READ;
+	log_debug("prefetching kernel %s", info->kernel);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS prefetch_kernel_read(linux_prefetch *pf, size_t slice) {
+	EFI_STATUS status;
+	char buff[64];
+	linux_data *data = pf->data;
+	size_t len = MIN(slice, data->kernel_size - pf->offset);
+	status = efi_file_chunked_read(
+		pf->kernel, pf->offset,
+		(UINT8*)data->kernel + pf->offset, len
+	);
+	if (EFI_ERROR(status)) {
+		log_warning(
+			"prefetch kernel %s failed: %s",
+			pf->info->kernel, efi_status_to_string(status)
+		);
+		return status;
+	}
+	pf->offset += len;
+	if (pf->offset < data->kernel_size) return EFI_SUCCESS;
+	pf->kernel->Close(pf->kernel);
+	pf->kernel = NULL;
+	pf->stage = PREFETCH_INITRAMFS;
+	log_info(
+		"prefetched kernel %s size %s (%" PRIu64 " bytes)",
+		pf->info->kernel,
+		format_size_float(buff, data->kernel_size),
+		(uint64_t)data->kernel_size
+	);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS prefetch_initramfs(linux_prefetch *pf) {
+	EFI_STATUS status;
+	size_t total = 0;
+	linux_data *data = pf->data;
+	status = linux_initramfs_open(pf->info, &pf->files, &total);
+	if (EFI_ERROR(status)) return status;
+	pf->stage = PREFETCH_DEVICETREE;
+	if (!pf->files) return EFI_SUCCESS;
+	if (pf->info->initramfs_stream) {
+		data->initramfs_files = pf->files;
+		data->initramfs_size = total;
+		pf->files = NULL;
+		return EFI_SUCCESS;
+	}
+	status = linux_initramfs_alloc(total, &data->initramfs);
+	if (EFI_ERROR(status)) return status;
+	data->initramfs_size = total;
+	pf->current = list_first(pf->files);
+	pf->offset = 0, pf->pos = 0;
+	pf->stage = PREFETCH_INITRAMFS_READ;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS prefetch_initramfs_read(linux_prefetch *pf, size_t slice) {
+	EFI_STATUS status;
+	char buff[64];
+	linux_data *data = pf->data;
+	LIST_DATA_DECLARE(file, pf->current, linux_initramfs_file*);
+	size_t len = MIN(slice, file->size - pf->offset);
+	if (pf->pos + pf->offset + len > data->initramfs_size) {
+		log_warning("prefetch initramfs %s size overflow", file->name);
+		return EFI_BAD_BUFFER_SIZE;
+	}
+	status = efi_file_chunked_read(
+		file->file, pf->offset,
+		(UINT8*)data->initramfs + pf->pos + pf->offset, len
+	);
+	if (EFI_ERROR(status)) {
+		log_warning(
+			"prefetch initramfs %s failed: %s",
+			file->name, efi_status_to_string(status)
+		);
+		return status;
+	}
+	pf->offset += len;
+	if (pf->offset < file->size) return EFI_SUCCESS;
+	log_info(
+		"prefetched initramfs %s size %s (%" PRIu64 " bytes)",
+		file->name, format_size_float(buff, file->size),
+		(uint64_t)file->size
+	);
+	pf->pos += file->size, pf->offset = 0;
+	if ((pf->current = pf->current->next)) return EFI_SUCCESS;
+	linux_initramfs_files_free(pf->files);
+	pf->files = NULL;
+	pf->stage = PREFETCH_DEVICETREE;
+	return EFI_SUCCESS;
+}
+
+/**
+ * @brief Create a speculative loader for Linux boot data
+ *
+ * The prefetch loads kernel, initramfs and device tree in small slices
+ * through linux_prefetch_step, so it can run while the menu is waiting.
+ * Boot arguments and device tree overlays are left to linux_prefetch_finish.
+ *
+ * @param info Pointer to linux_bootinfo structure, owned by the prefetch on success
+ * @return linux_prefetch* Pointer to new prefetch, or NULL on failure
+ */
+linux_prefetch* linux_prefetch_new(linux_bootinfo *info) {
+	linux_prefetch *pf;
+	if (!info || !info->root || !info->kernel) return NULL;
+	if (!(pf = malloc(sizeof(linux_prefetch)))) return NULL;
+	memset(pf, 0, sizeof(linux_prefetch));
+	if (!(pf->data = malloc(sizeof(linux_data)))) {
+		free(pf);
+		return NULL;
+	}
+	memset(pf->data, 0, sizeof(linux_data));
+	pf->info = info;
+	pf->stage = PREFETCH_KERNEL;
+	pf->status = EFI_NOT_READY;
+	pf->start = ticks_usec();
+	log_info("start prefetching kernel %s", info->kernel);
+	return pf;
+}
+
+/**
+ * @brief Run one slice of the prefetch
+ *
+ * @param pf Pointer to linux_prefetch
+ * @param slice Maximum bytes to read in this step
+ * @return EFI_NOT_READY if more steps are needed, EFI_SUCCESS when all files
+ *         are loaded, or appropriate error code on failure
+ */
+EFI_STATUS linux_prefetch_step(linux_prefetch *pf, size_t slice) {
+	EFI_STATUS status = EFI_SUCCESS;
+	if (!pf || slice == 0) return EFI_INVALID_PARAMETER;
+	switch (pf->stage) {
+		case PREFETCH_KERNEL: status = prefetch_kernel(pf); break;
+		case PREFETCH_KERNEL_READ: status = prefetch_kernel_read(pf, slice); break;
+		case PREFETCH_INITRAMFS: status = prefetch_initramfs(pf); break;
+		case PREFETCH_INITRAMFS_READ: status = prefetch_initramfs_read(pf, slice); break;
+		case PREFETCH_DEVICETREE:
+			status = linux_load_devicetree(pf->data, pf->info);
+			if (!EFI_ERROR(status)) pf->stage = PREFETCH_DONE;
+			break;
+		case PREFETCH_DONE:
+		case PREFETCH_FAILED: return pf->status;
+	}
+	if (EFI_ERROR(status)) {
+		pf->stage = PREFETCH_FAILED;
+		pf->status = status;
+	} else if (pf->stage == PREFETCH_DONE) {
+		pf->status = EFI_SUCCESS;
+		uint64_t used = ticks_usec() - pf->start;
+		if (pf->start > 0 && used > 0) log_info(
+			"prefetch of kernel %s done in %" PRIu64 "ms",
+			pf->info->kernel, used / 1000
+		);
+		else log_info("prefetch of kernel %s done", pf->info->kernel);
+	}
+	return pf->status;
+}
+
+/**
+ * @brief Complete the prefetch and take the prepared Linux boot data
+ *
+ * Any remaining files are loaded synchronously, then boot arguments and
+ * device tree overlays are prepared. The prefetch is freed in any case.
+ *
+ * @param pf Pointer to linux_prefetch
+ * @return linux_data* Pointer to prepared linux_data, or NULL on failure
+ */
+linux_data* linux_prefetch_finish(linux_prefetch *pf) {
+	EFI_STATUS status;
+	linux_data *data = NULL;
+	if (!pf) return NULL;
+	do {
+		status = linux_prefetch_step(pf, SIZE_MAX);
+	} while (status == EFI_NOT_READY);
+	if (!EFI_ERROR(status) && !EFI_ERROR(linux_data_finish(pf->data, pf->info))) {
+		data = pf->data;
+		pf->data = NULL;
+	}
+	linux_prefetch_free(pf);
+	return data;
+}
+
+/**
+ * @brief Discard a prefetch and everything it has loaded
+ *
+ * @param pf Pointer to linux_prefetch (may be NULL)
+ */
+void linux_prefetch_free(linux_prefetch *pf) {
+	if (!pf) return;
+	if (pf->kernel) pf->kernel->Close(pf->kernel);
+	linux_initramfs_files_free(pf->files);
+	if (pf->data) linux_data_clean(pf->data);
+	if (pf->info) linux_bootinfo_clean(pf->info);
+	memset(pf, 0, sizeof(linux_prefetch));
+	free(pf);
+}
@@ -1,6 +1,7 @@
 #include <Library/BaseLib.h>
 #include <Library/UefiLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include "embloader.h"
 #include "efi-utils.h"
 #include "encode.h"
@@ -23,6 +24,30 @@ EFI_STATUS embloader_start_efi(
 	EFI_DEVICE_PATH_PROTOCOL *dp,
 	void *img, size_t len,
 	const char *cmdline
+) {
+	return embloader_start_efi_ex(dp, img, len, cmdline, false);
+}
+
+/**
+ * @brief Start an EFI executable image and optionally release its source
+ *
+ * Same as embloader_start_efi, but when free_img is set the image data
+ * must be allocated by AllocatePages, and it is freed right after LoadImage
+ * has copied it, so the staging pages are not left behind while the image
+ * is running. The caller must not touch img after this call.
+ *
+ * @param dp Device path protocol for loading from device (can be NULL if img provided)
+ * @param img Pointer to image data in memory (can be NULL if dp provided)
+ * @param len Size of image data in bytes (ignored if img is NULL)
+ * @param cmdline Command line arguments for the executable (can be NULL)
+ * @param free_img Free the image pages after LoadImage
+ * @return EFI_STATUS No return on successful boot, or appropriate error code on failure
+ */
+EFI_STATUS embloader_start_efi_ex(
+	EFI_DEVICE_PATH_PROTOCOL *dp,
+	void *img, size_t len,
+	const char *cmdline,
+	bool free_img
 ) {
 	EFI_STATUS status;
 	EFI_HANDLE image = NULL;
@@ -35,6 +60,11 @@ EFI_STATUS embloader_start_efi(
 		free(s);
 	} else log_info("load efi image...");
 	status = gBS->LoadImage(FALSE, gImageHandle, dp, img, len, &image);
+	if (free_img && img) {
+		gBS->FreePages((UINTN)img, EFI_SIZE_TO_PAGES(len));
+		log_debug("released staging image pages at %p", img);
+		img = NULL;
+	}
 	if (EFI_ERROR(status) || !image) {
 		log_error("LoadImage failed: %s", efi_status_to_string(status));
 		goto fail;
@@ -63,6 +93,7 @@ EFI_STATUS embloader_start_efi(
 		log_info("use cmdline %s", cmdline);
 	}
 	log_info("start efi image...");
+	log_sync();
 	status = gBS->StartImage(image, NULL, NULL);
 	if (EFI_ERROR(status))
 		log_error("StartImage failed: %s", efi_status_to_string(status));
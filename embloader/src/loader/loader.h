@@ -1,6 +1,7 @@
 #ifndef EMBLOADER_LOADER_H
 #define EMBLOADER_LOADER_H
 #include "bootmenu.h"
+#include "linuxboot.h"
 struct loader_func {
 	const char *name;
 	embloader_loader_type type;
@@ -13,4 +14,6 @@ extern EFI_STATUS embloader_loader_boot_efi(embloader_loader *loader);
 extern EFI_STATUS embloader_loader_boot_linux_efi(embloader_loader *loader);
 extern EFI_STATUS embloader_loader_boot_linux(embloader_loader *loader);
 extern EFI_STATUS embloader_loader_boot_sdboot(embloader_loader *loader);
+extern linux_bootinfo *embloader_loader_linux_efi_bootinfo(embloader_loader *loader);
+extern linux_data *embloader_prefetch_take(embloader_loader *loader);
 #endif
@@ -0,0 +1,98 @@
+#include <Library/BaseLib.h>
+#include "linuxboot.h"
+#include "loader.h"
+#include "efi-utils.h"
+#include "log.h"
+
+#define PREFETCH_SLICE SIZE_256KB
+
+static embloader_loader *prefetch_loader = NULL;
+static linux_prefetch *prefetch_linux = NULL;
+
+static void prefetch_reset() {
+	efi_set_idle_handler(NULL, NULL);
+	if (prefetch_linux) linux_prefetch_free(prefetch_linux);
+	prefetch_linux = NULL;
+	prefetch_loader = NULL;
+}
+
+static bool prefetch_idle(void *data) {
+	EFI_STATUS status;
+	if (!prefetch_linux) return false;
+	status = linux_prefetch_step(prefetch_linux, PREFETCH_SLICE);
+	if (status == EFI_NOT_READY) return true;
+	efi_set_idle_handler(NULL, NULL);
+	if (EFI_ERROR(status)) {
+		log_warning(
+			"prefetch %s failed: %s, load again on boot",
+			prefetch_loader->name, efi_status_to_string(status)
+		);
+		prefetch_reset();
+	}
+	return false;
+}
+
+static embloader_loader *prefetch_get_default() {
+	list *p;
+	embloader_menu *menu = g_embloader.menu;
+	embloader_loader *loader;
+	if (!menu) return NULL;
+	if ((loader = embloader_find_loader(menu->default_entry))) return loader;
+	if ((p = list_first(menu->loaders))) return LIST_DATA(p, embloader_loader*);
+	return NULL;
+}
+
+/**
+ * @brief Start prefetching files of the default loader entry.
+ * While the menu is waiting, the kernel, initramfs and devicetree of the
+ * default linux-efi entry are loaded in small slices from efi_idle_stall.
+ * Disabled by menu.prefetch or when the menu has no timeout.
+ */
+void embloader_prefetch_start() {
+	embloader_loader *loader;
+	linux_bootinfo *info;
+	embloader_prefetch_discard(NULL);
+	if (!g_embloader.menu || g_embloader.menu->timeout == 0) return;
+	if (!confignode_path_get_bool(
+		g_embloader.config, "menu.prefetch", true, NULL
+	)) return;
+	if (!(loader = prefetch_get_default()) || !loader->node) return;
+	if (loader->type != LOADER_LINUX_EFI) return;
+	if (!(info = embloader_loader_linux_efi_bootinfo(loader))) return;
+	if (!(prefetch_linux = linux_prefetch_new(info))) {
+		linux_bootinfo_clean(info);
+		return;
+	}
+	prefetch_loader = loader;
+	efi_set_idle_handler(prefetch_idle, NULL);
+}
+
+/**
+ * @brief Take the prefetched linux boot data for a loader entry.
+ * Remaining files are loaded synchronously before returning.
+ *
+ * @param loader the loader entry being booted
+ * @return prepared linux_data owned by caller, or NULL if nothing was
+ *         prefetched for this loader or the prefetch failed
+ */
+linux_data *embloader_prefetch_take(embloader_loader *loader) {
+	linux_data *data;
+	if (!loader || !prefetch_linux || loader != prefetch_loader) return NULL;
+	efi_set_idle_handler(NULL, NULL);
+	data = linux_prefetch_finish(prefetch_linux);
+	prefetch_linux = NULL;
+	prefetch_loader = NULL;
+	if (data) log_info("use prefetched data for %s", loader->name);
+	return data;
+}
+
+/**
+ * @brief Discard the prefetch unless it belongs to the loader entry.
+ *
+ * @param keep the loader entry to keep the prefetch for, or NULL to discard all
+ */
+void embloader_prefetch_discard(embloader_loader *keep) {
+	if (!prefetch_linux || (keep && keep == prefetch_loader)) return;
+	log_debug("discard prefetch of %s", prefetch_loader->name);
+	prefetch_reset();
+}
@@ -2,10 +2,30 @@
 #include "linuxboot.h"
 #include "log.h"
 
+/**
+ * @brief Parse Linux boot info of a linux-efi loader entry.
+ * The boot arguments are prepared and the embloader volume is used as root.
+ *
+ * @param loader pointer to the loader configuration containing Linux boot info
+ * @return parsed linux_bootinfo owned by caller, or NULL on failure
+ */
+linux_bootinfo *embloader_loader_linux_efi_bootinfo(embloader_loader *loader) {
+	if (!loader || !loader->node) return NULL;
+	linux_bootinfo *info = linux_bootinfo_parse(loader->node);
+	if (!info) {
+		log_error("failed to parse linux-efi boot info");
+		return NULL;
+	}
+	info->bootargs_override = linux_bootinfo_prepare_bootargs(info);
+	info->root = g_embloader.dir.root;
+	return info;
+}
+
 /**
  * @brief Boot Linux kernel using EFI stub loader.
  * This function parses Linux boot configuration, loads the kernel and initrd,
  * then boots using the EFI stub method with proper kernel parameters.
+ * Data prefetched during the menu countdown is used when available.
  *
  * @param loader pointer to the loader configuration containing Linux boot info
  * @return EFI_SUCCESS on successful boot, EFI_INVALID_PARAMETER for invalid
@@ -13,21 +33,18 @@
  */
 EFI_STATUS embloader_loader_boot_linux_efi(embloader_loader *loader) {
 	if (!loader || !loader->node) return EFI_INVALID_PARAMETER;
-	linux_bootinfo *info = linux_bootinfo_parse(loader->node);
-	if (!info) {
-		log_error("failed to parse linux-efi boot info");
-		return EFI_LOAD_ERROR;
-	}
-	info->bootargs_override = linux_bootinfo_prepare_bootargs(info);
-	info->root = g_embloader.dir.root;
-	linux_data *data = linux_data_load(info);
+	linux_data *data = embloader_prefetch_take(loader);
 	if (!data) {
+		linux_bootinfo *info = embloader_loader_linux_efi_bootinfo(loader);
+		if (!info) return EFI_LOAD_ERROR;
+		data = linux_data_load(info);
 		linux_bootinfo_clean(info);
-		log_error("failed to load linux-efi data");
-		return EFI_LOAD_ERROR;
+		if (!data) {
+			log_error("failed to load linux-efi data");
+			return EFI_LOAD_ERROR;
+		}
 	}
-	linux_bootinfo_clean(info);
-	if (!data->kernel || data->kernel_size == 0) {
+	if ((!data->kernel && !data->kernel_path) || data->kernel_size == 0) {
 		linux_data_clean(data);
 		log_error("no kernel loaded for linux-efi");
 		return EFI_LOAD_ERROR;
@@ -79,6 +79,7 @@ EFI_STATUS embloader_loader_boot_reboot(embloader_loader *loader) {
 		if (data) free(data);
 		return EFI_INVALID_PARAMETER;
 	}
+	log_sync();
 	gRT->ResetSystem(type, EFI_SUCCESS, data ? (UINTN)strlen(data) : 0, data);
 	gBS->Stall(500000);
 	log_warning("ResetSystem returned unexpectedly");
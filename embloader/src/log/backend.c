@@ -15,6 +15,24 @@ int log_backend_write(log_backend *backend, log_item *item) {
 	return backend->base->write(backend, item);
 }
 
+/**
+ * @brief Format a log item with the line format of a backend.
+ * The result lives in the buffer of the backend and is only valid until the
+ * next item is formatted.
+ *
+ * @param backend the log backend
+ * @param item    the log item to format
+ * @param len     receive the length of the formatted line (may be NULL)
+ * @return the formatted line, or NULL on failure
+ */
+char* log_backend_format(log_backend *backend, log_item *item, size_t *len) {
+	if (!backend || !backend->format) return NULL;
+	return log_format_render(
+		backend->format, item, 1,
+		&backend->buff, &backend->buff_size, len
+	);
+}
+
 /**
  * @brief Initialize a log backend.
  * Calls the backend's base init function if one is provided.
@@ -40,31 +58,36 @@ int log_backend_deinit(log_backend *backend) {
 }
 
 /**
- * @brief Flush all buffered log items to a specific backend.
- * Iterates through all stored log items and writes unflushed ones to the
- * given backend. Also recalculates the current log size.
+ * @brief Write out data buffered by a log backend.
+ * Calls the backend's base sync function if one is provided.
  *
- * @param backend the log backend to flush to
- * @param force   if true, flush all items regardless of their flushed state
+ * @param backend the log backend to sync
+ * @return 0 on success or if no sync function exists, -1 on failure
+ */
+int log_backend_sync(log_backend *backend) {
+	if (!backend || !backend->base || !backend->base->sync) return 0;
+	return backend->base->sync(backend);
+}
+
+/**
+ * @brief Write out all pending log output.
+ * Flushes stored items to every backend and syncs buffered backends, used
+ * before control leaves embloader (starting an image, reset or exit).
  */
-void log_flush_to(log_backend *backend, bool force) {
-	list *l;
-	log_size_cur = 0;
-	if ((l = list_first(log_items))) do {
-		LIST_DATA_DECLARE(item, l, log_item*);
-		if (!item) continue;
-		log_size_cur += item->size;
-		if (item->log_flushed && !force) continue;
-		if (log_backend_write(backend, item) < 0) continue;
-		item->log_flushed = true;
-	} while ((l = l->next));
+void log_sync() {
+	list *b;
+	log_flush_fast();
+	if ((b = list_first(log_backends))) do {
+		LIST_DATA_DECLARE(backend, b, log_backend*);
+		log_backend_sync(backend);
+	} while ((b = b->next));
 }
 
 /**
  * @brief Create a new log backend instance.
- * Allocates a backend, optionally allocates a context of ctx_size bytes,
- * initializes it, flushes existing log items to it, and adds it to the
- * global backend list.
+ * Allocates a backend, compiles its filter rules and line format,
+ * optionally allocates a context of ctx_size bytes, initializes it, flushes
+ * existing log items to it, and adds it to the global backend list.
  *
  * @param base   the backend base type (must not be NULL)
  * @param name   optional name for the backend (auto-generated if NULL)
@@ -82,6 +105,11 @@ log_backend* log_backend_create(
 	memset(backend, 0, sizeof(log_backend));
 	backend->base = base;
 	backend->config = config;
+	if (config && !(backend->filter = log_filter_compile(config))) goto fail;
+	backend->format = log_format_compile(
+		confignode_path_get_cstr(config, "format", NULL, NULL)
+	);
+	if (!backend->format) goto fail;
 	if (!name) {
 		int id = (log_backends ? list_count(log_backends) : 0) + 1;
 		int ret = asprintf(&backend->name, "%s-%d", base->name, id);
@@ -114,6 +142,9 @@ void log_backend_destroy(log_backend *backend) {
 	list_obj_del_data(&log_backends, backend, NULL);
 	log_backend_deinit(backend);
 	if (backend->name) free(backend->name);
+	if (backend->filter) log_filter_free(backend->filter);
+	if (backend->format) log_format_free(backend->format);
+	if (backend->buff) free(backend->buff);
 	if (backend->ctx && backend->base && backend->base->ctx_size > 0)
 		free(backend->ctx);
 	free(backend);
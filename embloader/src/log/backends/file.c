@@ -3,19 +3,40 @@
 #include "efi-utils.h"
 #include "file-utils.h"
 #include "encode.h"
+#include <inttypes.h>
 #include <unistd.h>
 
+#define LOG_FILE_BUFFER_DEFAULT 0x10000
+#define LOG_FILE_BUFFER_MIN 0x200
+#define LOG_FILE_BUFFER_MAX 0x1000000
+
 struct log_file_ctx {
 	EFI_FILE_PROTOCOL *file;
 	bool truncate;
+	bool sync;
 	encoding encode;
+	char *buff;
+	size_t size;
+	size_t used;
 };
 
+static int log_file_flush(struct log_file_ctx *ctx) {
+	EFI_STATUS status = EFI_SUCCESS;
+	UINTN len = ctx->used;
+	if (!ctx->file) return -1;
+	if (len > 0) status = ctx->file->Write(ctx->file, &len, ctx->buff);
+	ctx->used = 0;
+	if (EFI_ERROR(status)) return -1;
+	ctx->file->Flush(ctx->file);
+	return 0;
+}
+
 static int log_file_init(log_backend *backend) {
 	EFI_STATUS status;
 	struct log_file_ctx *ctx;
 	EFI_FILE_PROTOCOL *file = NULL;
 	char *path = NULL, *encode = NULL;
+	int64_t size;
 	if (!backend || !(ctx = backend->ctx)) return -1;
 	if (!g_embloader.dir.dir) {
 		log_warning("no directory handle for log file");
@@ -35,6 +56,24 @@ static int log_file_init(log_backend *backend) {
 		free(encode);
 	}
 	ctx->truncate = confignode_path_get_bool(backend->config, "truncate", false, NULL);
+	ctx->sync = confignode_path_get_bool(backend->config, "sync", false, NULL);
+	size = confignode_path_get_int(
+		backend->config, "buffer-size", LOG_FILE_BUFFER_DEFAULT, NULL
+	);
+	if (size <= 0 || size > LOG_FILE_BUFFER_MAX) {
+		log_warning(
+			"invalid log file buffer size %" PRId64 ", use default",
+			size
+		);
+		size = LOG_FILE_BUFFER_DEFAULT;
+	}
+	if (size < LOG_FILE_BUFFER_MIN) size = LOG_FILE_BUFFER_MIN;
+	ctx->size = (size_t) size;
+	if (!(ctx->buff = malloc(ctx->size))) {
+		log_warning("failed to allocate log file buffer");
+		goto fail;
+	}
+	ctx->used = 0;
 	status = efi_open(
 		g_embloader.dir.dir, &file, path,
 		EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE,
@@ -55,58 +94,86 @@ static int log_file_init(log_backend *backend) {
 	ctx->file = file;
 	return 0;
 fail:
+	if (ctx->buff) free(ctx->buff);
+	ctx->buff = NULL;
 	if (path) free(path);
 	return -1;
 }
 
+static int log_file_sync(log_backend *backend) {
+	struct log_file_ctx *ctx;
+	if (!backend || !(ctx = backend->ctx)) return -1;
+	return log_file_flush(ctx);
+}
+
 static int log_file_deinit(log_backend *backend) {
 	struct log_file_ctx *ctx;
 	if (!backend || !(ctx = backend->ctx)) return -1;
-	if (ctx->file) ctx->file->Close(ctx->file);
+	if (ctx->file) {
+		log_file_flush(ctx);
+		ctx->file->Close(ctx->file);
+	}
+	if (ctx->buff) free(ctx->buff);
 	ctx->file = NULL;
+	ctx->buff = NULL;
 	return 0;
 }
 
+static void log_file_append(struct log_file_ctx *ctx, const char *str, size_t len) {
+	UINTN wlen;
+	if (len > ctx->size - ctx->used) log_file_flush(ctx);
+	if (len <= ctx->size - ctx->used) {
+		memcpy(ctx->buff + ctx->used, str, len);
+		ctx->used += len;
+	} else if (ctx->file) {
+		wlen = len;
+		ctx->file->Write(ctx->file, &wlen, (void*) str);
+	}
+}
+
+static void log_file_append_encode(struct log_file_ctx *ctx, const char *str, size_t len) {
+	encode_convert_ctx enc = {
+		.in = {
+			.src = ENC_UTF8,
+			.dst = ctx->encode,
+			.src_ptr = str,
+			.src_size = len,
+		},
+	};
+	while (enc.in.src_size > 0) {
+		/* converters always terminate the output */
+		if (ctx->size - ctx->used < 8) log_file_flush(ctx);
+		enc.in.dst_ptr = ctx->buff + ctx->used;
+		enc.in.dst_size = ctx->size - ctx->used;
+		if (EFI_ERROR(encode_convert(&enc))) break;
+		ctx->used += enc.out.dst_wrote;
+		enc.in.src_ptr = enc.out.src_end;
+		enc.in.src_size -= enc.out.src_used;
+		if (enc.in.src_size == 0) break;
+		if (enc.out.src_used == 0 && ctx->used == 0) break;
+		log_file_flush(ctx);
+	}
+}
+
+/*
+ * Lines are collected in the buffer and written out when it is full, when a
+ * warning or error is logged, or when the log is synced. With sync enabled
+ * every line is written and flushed immediately.
+ */
 static int log_file_writer(log_backend *backend, log_item *item) {
-	int ret = -1;
-	char *format, *formatted;
+	const char *formatted;
 	struct log_file_ctx *ctx;
-	EFI_STATUS st;
-	UINTN len, wlen;
+	size_t len = 0;
 	if (!backend || !item || !(ctx = backend->ctx)) return -1;
-	if (!log_check_filter(item, backend->config)) return 0;
-	format = confignode_path_get_string(backend->config, "format", NULL, NULL);
-	formatted = log_formatter(item, format, 1);
-	if (formatted && ctx->file) {
-		len = strlen(formatted);
-		if (ctx->encode != ENC_NONE && ctx->encode != ENC_UTF8) {
-			char buff[256];
-			encode_convert_ctx enc = {
-				.in = {
-					.src = ENC_UTF8,
-					.dst = ctx->encode,
-					.dst_ptr = buff,
-					.dst_size = sizeof(buff),
-					.src_ptr = formatted,
-					.src_size = len,
-				},
-			};
-			while (enc.in.src_size > 0) {
-				st = encode_convert(&enc);
-				if (EFI_ERROR(st)) break;
-				if (enc.out.dst_wrote == 0) break;
-				wlen = enc.out.dst_wrote;
-				ctx->file->Write(ctx->file, &wlen, buff);
-				enc.in.src_ptr = enc.out.src_end;
-				enc.in.src_size -= enc.out.src_used;
-			}
-		} else ctx->file->Write(ctx->file, &len, formatted);
-		ctx->file->Flush(ctx->file);
-		ret = 0;
-	}
-	if (formatted) free(formatted);
-	if (format) free(format);
-	return ret;
+	if (!log_check_filter(item, backend->filter)) return 0;
+	if (!ctx->file || !ctx->buff) return -1;
+	if (!(formatted = log_backend_format(backend, item, &len))) return -1;
+	if (ctx->encode != ENC_NONE && ctx->encode != ENC_UTF8)
+		log_file_append_encode(ctx, formatted, len);
+	else log_file_append(ctx, formatted, len);
+	if (ctx->sync || item->level >= LOG_WARNING)
+		return log_file_flush(ctx);
+	return 0;
 }
 
 log_backend_base log_backend_file = {
@@ -114,5 +181,6 @@ log_backend_base log_backend_file = {
 	.init = log_file_init,
 	.deinit = log_file_deinit,
 	.write = log_file_writer,
+	.sync = log_file_sync,
 	.ctx_size = sizeof(struct log_file_ctx),
 };
@@ -1,28 +1,38 @@
 #include "../internal.h"
 #include <unistd.h>
 
-static int log_stdio_writer(log_backend *backend, log_item *item) {
-	int ret = -1, fd = 1;
-	char *format, *output, *formatted;
-	if (!backend || !item) return -1;
-	if (!log_check_filter(item, backend->config)) return 0;
-	format = confignode_path_get_string(backend->config, "format", NULL, NULL);
-	output = confignode_path_get_string(backend->config, "output", NULL, NULL);
-	formatted = log_formatter(item, format, 1);
+struct log_stdio_ctx {
+	int fd;
+};
+
+static int log_stdio_init(log_backend *backend) {
+	struct log_stdio_ctx *ctx;
+	const char *output;
+	if (!backend || !(ctx = backend->ctx)) return -1;
+	ctx->fd = 1;
+	output = confignode_path_get_cstr(backend->config, "output", NULL, NULL);
 	if (output) {
-		if (strcasecmp(output, "stdout") == 0) fd = 1;
-		else if (strcasecmp(output, "stderr") == 0) fd = 2;
-		else fd = -1;
+		if (strcasecmp(output, "stdout") == 0) ctx->fd = 1;
+		else if (strcasecmp(output, "stderr") == 0) ctx->fd = 2;
+		else ctx->fd = -1;
 	}
-	if (formatted && fd > 0)
-		ret = (int)write(fd, formatted, strlen(formatted));
-	if (formatted) free(formatted);
-	if (format) free(format);
-	if (output) free(output);
-	return ret;
+	return 0;
+}
+
+static int log_stdio_writer(log_backend *backend, log_item *item) {
+	struct log_stdio_ctx *ctx;
+	const char *formatted;
+	size_t len = 0;
+	if (!backend || !item || !(ctx = backend->ctx)) return -1;
+	if (!log_check_filter(item, backend->filter)) return 0;
+	if (ctx->fd <= 0) return -1;
+	if (!(formatted = log_backend_format(backend, item, &len))) return -1;
+	return (int)write(ctx->fd, formatted, len);
 }
 
 log_backend_base log_backend_stdio = {
 	.name = "stdio",
+	.init = log_stdio_init,
 	.write = log_stdio_writer,
+	.ctx_size = sizeof(struct log_stdio_ctx),
 };
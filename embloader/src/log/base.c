@@ -1,7 +1,95 @@
+#include <inttypes.h>
 #include "internal.h"
 #include "embloader.h"
+#include "ticks.h"
 #include <Library/UefiRuntimeServicesTableLib.h>
 
+#define USEC_PER_SEC 1000000ULL
+#define SEC_PER_DAY 86400ULL
+
+/* wall clock read once on the first log item, items only store an offset */
+static struct {
+	bool init;
+	bool ticks;
+	EFI_TIME time;
+	uint64_t usec;
+} log_epoch;
+
+/* days since 1970-01-01 of a civil date */
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+	y -= m <= 2;
+	int64_t era = (y >= 0 ? y : y - 399) / 400;
+	unsigned yoe = (unsigned)(y - era * 400);
+	unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + (int64_t) doe - 719468;
+}
+
+static void civil_from_days(int64_t z, EFI_TIME *time) {
+	z += 719468;
+	int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	unsigned doe = (unsigned)(z - era * 146097);
+	unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	unsigned mp = (5 * doy + 2) / 153;
+	time->Day = doy - (153 * mp + 2) / 5 + 1;
+	time->Month = mp < 10 ? mp + 3 : mp - 9;
+	time->Year = (int64_t) yoe + era * 400 + (time->Month <= 2);
+}
+
+static uint64_t efi_time_to_usec(EFI_TIME *time) {
+	int64_t days = days_from_civil(time->Year, time->Month, time->Day);
+	uint64_t sec = days * SEC_PER_DAY + time->Hour * 3600 + time->Minute * 60 + time->Second;
+	return sec * USEC_PER_SEC + time->Nanosecond / 1000;
+}
+
+/**
+ * @brief Get the microseconds elapsed since the log epoch.
+ * The first call reads the wall clock once and becomes the epoch, later
+ * calls only read the CPU tick counter. GetTime is only used per call when
+ * no tick counter is available (e.g. in some hypervisors).
+ *
+ * @return microseconds since the first log item
+ */
+static uint64_t log_clock_usec() {
+	uint64_t now;
+	EFI_TIME time;
+	if (!log_epoch.init) {
+		if (EFI_ERROR(gRT->GetTime(&log_epoch.time, NULL)))
+			memset(&log_epoch.time, 0, sizeof(EFI_TIME));
+		log_epoch.usec = ticks_usec();
+		log_epoch.ticks = log_epoch.usec != 0;
+		if (!log_epoch.ticks)
+			log_epoch.usec = efi_time_to_usec(&log_epoch.time);
+		log_epoch.init = true;
+		return 0;
+	}
+	if (log_epoch.ticks) now = ticks_usec();
+	else if (EFI_ERROR(gRT->GetTime(&time, NULL))) return 0;
+	else now = efi_time_to_usec(&time);
+	return now > log_epoch.usec ? now - log_epoch.usec : 0;
+}
+
+/**
+ * @brief Get the wall clock time of a log item.
+ * Derived from the time read at the log epoch plus the offset of the item.
+ *
+ * @param item the log item (must not be NULL)
+ * @param time receive the wall clock time
+ */
+void log_item_time(log_item *item, EFI_TIME *time) {
+	uint64_t usec;
+	*time = log_epoch.time;
+	if (time->Month == 0 || time->Day == 0) return;
+	usec = efi_time_to_usec(&log_epoch.time) + item->usec;
+	time->Nanosecond = (usec % USEC_PER_SEC) * 1000;
+	usec /= USEC_PER_SEC;
+	time->Second = usec % 60;
+	time->Minute = usec / 60 % 60;
+	time->Hour = usec / 3600 % 24;
+	civil_from_days(usec / SEC_PER_DAY, time);
+}
+
 /**
  * @brief Convert a log level enum value to its string representation.
  *
@@ -46,7 +134,8 @@ bool log_level_from_str(const char *str, log_level *level) {
 /**
  * @brief Create a new log item with all associated metadata.
  * All string fields (tag, file, function, content) are copied into a single
- * contiguous allocation using a flexible array member, avoiding fragmentation.
+ * record of the log store using a flexible array member, avoiding any heap
+ * allocation per message.
  *
  * @param level    log severity level
  * @param tag      log tag string (may be NULL)
@@ -54,7 +143,7 @@ bool log_level_from_str(const char *str, log_level *level) {
  * @param function source function name (may be NULL)
  * @param lineno   source line number
  * @param content  log message content (must not be NULL)
- * @return newly allocated log_item (caller must free), or NULL on failure
+ * @return log_item owned by the log store, or NULL on failure
  */
 log_item* log_item_create(
 	log_level level,
@@ -73,13 +162,11 @@ log_item* log_item_create(
 	if (content) content_len = strlen(content);
 	total_len = sizeof(log_item) + tag_len + file_len + function_len + content_len + 4;
 	if (total_len >= UINT32_MAX) return NULL;
-	log_item *item = malloc(total_len);
+	log_item *item = log_store_alloc(total_len);
 	if (!item) return NULL;
-	memset(item, 0, total_len);
-	item->size = total_len;
 	item->level = level;
 	item->lineno = lineno;
-	gRT->GetTime(&item->time, NULL);
+	item->usec = log_clock_usec();
 	if (tag) {
 		item->tag = &item->data[cur_off];
 		memcpy(&item->data[cur_off], tag, tag_len);
@@ -114,6 +201,15 @@ void log_init() {
 		log_backend_create(&log_backend_stdio, NULL, NULL);
 	confignode *backends = confignode_path_lookup(r, "log.backends", false);
 	if (backends) log_backends_init(backends);
-	log_size_limit = confignode_path_get_int(r, "log.size-limit", log_size_limit, NULL);
+	int64_t limit = confignode_path_get_int(r, "log.size-limit", log_size_limit, NULL);
+	if (limit < LOG_STORE_MIN) {
+		log_warning(
+			"log size limit %" PRId64 " too small, use %d bytes",
+			limit, LOG_STORE_MIN
+		);
+		limit = LOG_STORE_MIN;
+	}
+	if (!log_store_resize(limit))
+		log_warning("cannot resize log store to %" PRIu64 " bytes", (uint64_t) limit);
 	log_info("log system initialized");
 }
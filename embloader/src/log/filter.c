@@ -1,16 +1,30 @@
 #include "internal.h"
 #include "regexp.h"
 
+struct log_filter_regex {
+	Reprog **progs;
+	size_t count;
+};
+
+struct log_filter {
+	log_level min_level;
+	log_level max_level;
+	struct log_filter_regex tag;
+	struct log_filter_regex file;
+	struct log_filter_regex function;
+	struct log_filter_regex content;
+	struct log_filter_regex line;
+};
+
 static log_level confignode_path_get_log_level(
 	confignode* node,
 	const char* path,
 	log_level def,
 	bool* ok
 ) {
-	bool vok = false;
 	if (ok) *ok = false;
 	if (!node || !path) return def;
-	char *str = confignode_path_get_string(node, path, NULL, &vok);
+	const char *str = confignode_path_get_cstr(node, path, NULL, NULL);
 	if (!str) return def;
 	log_level level;
 	if (!log_level_from_str(str, &level)) {
@@ -22,61 +36,123 @@ static log_level confignode_path_get_log_level(
 		);
 		level = def;
 	}
-	if (ok) *ok = vok;
-	free(str);
+	if (ok) *ok = true;
 	return level;
 }
 
-static bool log_check_regex_filter(const char *value, confignode *config) {
-	if (!value) return true;
-	if (confignode_is_type(config, CONFIGNODE_TYPE_ARRAY)){
-		confignode_foreach(iter, config) {
-			if (!iter.node) continue;
-			if (!log_check_regex_filter(value, iter.node)) return false;
-		}
-		return true;
+static void log_filter_regex_add(struct log_filter_regex *regex, confignode *config) {
+	Reprog **progs, *prog;
+	const char *error = NULL;
+	if (confignode_is_type(config, CONFIGNODE_TYPE_ARRAY)) {
+		confignode_foreach(iter, config)
+			if (iter.node) log_filter_regex_add(regex, iter.node);
+		return;
+	}
+	if (!confignode_is_type(config, CONFIGNODE_TYPE_VALUE)) return;
+	const char *pattern = confignode_value_get_cstr(config, NULL, NULL);
+	if (!pattern) return;
+	if (!(prog = regexp_comp(pattern, 0, &error))) {
+		log_warning(
+			"ignore invalid log filter pattern '%s': %s",
+			pattern, error ? error : "unknown error"
+		);
+		return;
+	}
+	progs = realloc(regex->progs, (regex->count + 1) * sizeof(Reprog*));
+	if (!progs) {
+		regexp_free(prog);
+		return;
 	}
-	if (!confignode_is_type(config, CONFIGNODE_TYPE_VALUE)) return true;
-	char *pattern = confignode_value_get_string(config, NULL, NULL);
-	if (!pattern) return true;
-	int ret = regexp_match(pattern, value, 0);
-	free(pattern);
-	return ret != 1;
+	progs[regex->count++] = prog;
+	regex->progs = progs;
 }
 
-static bool log_check_regex_filter_path(const char *value, confignode* config, const char* path) {
-	confignode* n = confignode_path_lookup(config, path, false);
-	if (!n) return true;
-	return log_check_regex_filter(value, n);
+static void log_filter_regex_compile(
+	struct log_filter_regex *regex,
+	confignode *config,
+	const char *path
+) {
+	confignode *n = confignode_path_lookup(config, path, false);
+	if (n) log_filter_regex_add(regex, n);
+}
+
+static void log_filter_regex_free(struct log_filter_regex *regex) {
+	for (size_t i = 0; i < regex->count; i++)
+		regexp_free(regex->progs[i]);
+	if (regex->progs) free(regex->progs);
+	memset(regex, 0, sizeof(struct log_filter_regex));
+}
+
+static bool log_check_regex_filter(const char *value, struct log_filter_regex *regex) {
+	if (!value) return true;
+	for (size_t i = 0; i < regex->count; i++)
+		if (regexp_exec(regex->progs[i], value, NULL, 0) != 0)
+			return false;
+	return true;
+}
+
+/**
+ * @brief Compile the filter rules of a backend config node.
+ * Level bounds are parsed and regex patterns of tag, file, function,
+ * content and line are compiled once, so checking an item needs no
+ * config lookups. Invalid patterns are ignored.
+ *
+ * @param config configuration node containing filter rules (may be NULL)
+ * @return the compiled filter, or NULL if config is NULL or on failure
+ */
+log_filter* log_filter_compile(confignode *config) {
+	log_filter *filter;
+	if (!config) return NULL;
+	if (!(filter = malloc(sizeof(log_filter)))) return NULL;
+	memset(filter, 0, sizeof(log_filter));
+	filter->min_level = confignode_path_get_log_level(config, "min-level", LOG_DEBUG, NULL);
+	filter->max_level = confignode_path_get_log_level(config, "max-level", LOG_ERROR, NULL);
+	log_filter_regex_compile(&filter->tag, config, "tag");
+	log_filter_regex_compile(&filter->file, config, "file");
+	log_filter_regex_compile(&filter->function, config, "function");
+	log_filter_regex_compile(&filter->content, config, "content");
+	log_filter_regex_compile(&filter->line, config, "line");
+	return filter;
 }
 
 /**
- * @brief Check whether a log item passes the filter criteria of a config node.
+ * @brief Free a filter created by log_filter_compile.
+ *
+ * @param filter the filter to free (safe to pass NULL)
+ */
+void log_filter_free(log_filter *filter) {
+	if (!filter) return;
+	log_filter_regex_free(&filter->tag);
+	log_filter_regex_free(&filter->file);
+	log_filter_regex_free(&filter->function);
+	log_filter_regex_free(&filter->content);
+	log_filter_regex_free(&filter->line);
+	free(filter);
+}
+
+/**
+ * @brief Check whether a log item passes a compiled filter.
  * Evaluates min-level, max-level, and regex filters on tag, file, function,
- * content, and line fields. If no config is provided, the item passes.
+ * content, and line fields. If no filter is provided, the item passes.
  *
  * @param item   the log item to check (must not be NULL)
- * @param config configuration node containing filter rules (may be NULL)
+ * @param filter compiled filter of the backend (may be NULL)
  * @return true if the item passes all filters, false otherwise
  */
-bool log_check_filter(log_item *item, confignode *config) {
-	bool ok = false;
-	log_level level = LOG_DEBUG;
+bool log_check_filter(log_item *item, log_filter *filter) {
 	if (!item) return false;
-	if (!config) return true;
-	level = confignode_path_get_log_level(config, "min-level", LOG_DEBUG, &ok);
-	if (ok && level > item->level) return false;
-	level = confignode_path_get_log_level(config, "max-level", LOG_ERROR, &ok);
-	if (ok && level < item->level) return false;
-	if (!log_check_regex_filter_path(item->tag, config, "tag")) return false;
-	if (!log_check_regex_filter_path(item->file, config, "file")) return false;
-	if (!log_check_regex_filter_path(item->function, config, "function")) return false;
-	if (!log_check_regex_filter_path(item->content, config, "content")) return false;
-	if (confignode_path_lookup(config, "line", false)) {
+	if (!filter) return true;
+	if (filter->min_level > item->level) return false;
+	if (filter->max_level < item->level) return false;
+	if (!log_check_regex_filter(item->tag, &filter->tag)) return false;
+	if (!log_check_regex_filter(item->file, &filter->file)) return false;
+	if (!log_check_regex_filter(item->function, &filter->function)) return false;
+	if (!log_check_regex_filter(item->content, &filter->content)) return false;
+	if (filter->line.count > 0) {
 		char buff[1024];
 		memset(buff, 0, sizeof(buff));
 		snprintf(buff, sizeof(buff) - 1, "%s:%d", item->file, item->lineno);
-		if (!log_check_regex_filter(buff, confignode_path_lookup(config, "line", false)))
+		if (!log_check_regex_filter(buff, &filter->line))
 			return false;
 	}
 	return true;
@@ -7,11 +7,13 @@ enum log_format_specifier {
 	LOG_FMT_UINT,
 	LOG_FMT_SINT,
 	LOG_FMT_LOG_LEVEL,
+	LOG_FMT_OFFSET,
 };
 
 struct log_formatter {
 	char tag;
 	bool ref;
+	bool time;
 	enum log_format_specifier type;
 	size_t off;
 	size_t len;
@@ -19,30 +21,38 @@ struct log_formatter {
 };
 
 static struct log_formatter default_formatters[] = {
-	{ .tag = '%', .type = LOG_FMT_STRING,    .ref = false,  .data = "%"                                                           },
-	{ .tag = 'l', .type = LOG_FMT_LOG_LEVEL, .ref = true,   .off = offsetof(log_item, level),           .len = sizeof(log_level), },
-	{ .tag = 't', .type = LOG_FMT_STRING,    .ref = true,   .off = offsetof(log_item, tag),                                       },
-	{ .tag = 'f', .type = LOG_FMT_STRING,    .ref = true,   .off = offsetof(log_item, file),                                      },
-	{ .tag = 'F', .type = LOG_FMT_STRING,    .ref = true,   .off = offsetof(log_item, function),                                  },
-	{ .tag = 'L', .type = LOG_FMT_SINT,      .ref = true,   .off = offsetof(log_item, lineno),          .len = sizeof(int),       },
-	{ .tag = 'm', .type = LOG_FMT_STRING,    .ref = true,   .off = offsetof(log_item, content),                                   },
-	{ .tag = 'Y', .type = LOG_FMT_UINT,      .ref = true,   .off = offsetof(log_item, time.Year),       .len = sizeof(UINT16),    },
-	{ .tag = 'M', .type = LOG_FMT_UINT,      .ref = true,   .off = offsetof(log_item, time.Month),      .len = sizeof(UINT8),     },
-	{ .tag = 'D', .type = LOG_FMT_UINT,      .ref = true,   .off = offsetof(log_item, time.Day),        .len = sizeof(UINT8),     },
-	{ .tag = 'h', .type = LOG_FMT_UINT,      .ref = true,   .off = offsetof(log_item, time.Hour),       .len = sizeof(UINT8),     },
-	{ .tag = 'i', .type = LOG_FMT_UINT,      .ref = true,   .off = offsetof(log_item, time.Minute),     .len = sizeof(UINT8),     },
-	{ .tag = 's', .type = LOG_FMT_UINT,      .ref = true,   .off = offsetof(log_item, time.Second),     .len = sizeof(UINT8),     },
-	{ .tag = 'S', .type = LOG_FMT_UINT,      .ref = true,   .off = offsetof(log_item, time.Nanosecond), .len = sizeof(UINT32),    },
+	{ .tag = '%', .type = LOG_FMT_STRING,    .ref = false,                .data = "%"                                                          },
+	{ .tag = 'l', .type = LOG_FMT_LOG_LEVEL, .ref = true,                 .off = offsetof(log_item, level),     .len = sizeof(log_level), },
+	{ .tag = 't', .type = LOG_FMT_STRING,    .ref = true,                 .off = offsetof(log_item, tag),                                 },
+	{ .tag = 'f', .type = LOG_FMT_STRING,    .ref = true,                 .off = offsetof(log_item, file),                                },
+	{ .tag = 'F', .type = LOG_FMT_STRING,    .ref = true,                 .off = offsetof(log_item, function),                            },
+	{ .tag = 'L', .type = LOG_FMT_SINT,      .ref = true,                 .off = offsetof(log_item, lineno),    .len = sizeof(int),       },
+	{ .tag = 'm', .type = LOG_FMT_STRING,    .ref = true,                 .off = offsetof(log_item, content),                             },
+	{ .tag = 'r', .type = LOG_FMT_OFFSET,    .ref = true,                 .off = offsetof(log_item, usec),      .len = sizeof(uint64_t),  },
+	{ .tag = 'Y', .type = LOG_FMT_UINT,      .ref = true, .time = true,   .off = offsetof(EFI_TIME, Year),       .len = sizeof(UINT16),    },
+	{ .tag = 'M', .type = LOG_FMT_UINT,      .ref = true, .time = true,   .off = offsetof(EFI_TIME, Month),      .len = sizeof(UINT8),     },
+	{ .tag = 'D', .type = LOG_FMT_UINT,      .ref = true, .time = true,   .off = offsetof(EFI_TIME, Day),        .len = sizeof(UINT8),     },
+	{ .tag = 'h', .type = LOG_FMT_UINT,      .ref = true, .time = true,   .off = offsetof(EFI_TIME, Hour),       .len = sizeof(UINT8),     },
+	{ .tag = 'i', .type = LOG_FMT_UINT,      .ref = true, .time = true,   .off = offsetof(EFI_TIME, Minute),     .len = sizeof(UINT8),     },
+	{ .tag = 's', .type = LOG_FMT_UINT,      .ref = true, .time = true,   .off = offsetof(EFI_TIME, Second),     .len = sizeof(UINT8),     },
+	{ .tag = 'S', .type = LOG_FMT_UINT,      .ref = true, .time = true,   .off = offsetof(EFI_TIME, Nanosecond), .len = sizeof(UINT32),    },
 	{}
 };
 
+/* write v as decimal digits ending right before end */
+static char *format_uint(char *end, UINT64 v) {
+	do *--end = '0' + v % 10; while ((v /= 10));
+	return end;
+}
+
 static const char *resolve_specifier(
 	struct log_formatter *fmt,
-	log_item *item,
+	void *base,
 	char *num_buf,
 	size_t num_buf_size
 ) {
-	void *ptr = fmt->ref ? (void *)item + fmt->off : &fmt->data;
+	void *ptr = fmt->ref ? base + fmt->off : &fmt->data;
+	char *end = num_buf + num_buf_size - 1;
 	union{
 		UINT64 u;
 		INT64 s;
@@ -58,8 +68,8 @@ static const char *resolve_specifier(
 				case sizeof(UINT64): i.u = *(UINT64 *)ptr; break;
 				default: i.u = 0; break;
 			}
-			snprintf(num_buf, num_buf_size, "%llu", i.u);
-			return num_buf;
+			*end = 0;
+			return format_uint(end, i.u);
 		case LOG_FMT_SINT:
 			switch (fmt->len) {
 				case sizeof(INT8): i.s = *(INT8 *)ptr; break;
@@ -68,26 +78,52 @@ static const char *resolve_specifier(
 				case sizeof(INT64): i.s = *(INT64 *)ptr; break;
 				default: i.s = 0; break;
 			}
-			snprintf(num_buf, num_buf_size, "%lld", i.s);
+			*end = 0;
+			if (i.s >= 0) return format_uint(end, i.s);
+			num_buf = format_uint(end, -(UINT64) i.s);
+			*--num_buf = '-';
 			return num_buf;
 		case LOG_FMT_LOG_LEVEL:
 			return log_level_str(*(log_level *)ptr);
+		case LOG_FMT_OFFSET:
+			i.u = *(UINT64 *)ptr;
+			num_buf = end - 2;
+			memcpy(num_buf, "ms", 3);
+			for (int n = 0; n < 3; n++, i.u /= 10)
+				*--num_buf = '0' + i.u % 10;
+			*--num_buf = '.';
+			num_buf = format_uint(num_buf, i.u);
+			*--num_buf = '+';
+			return num_buf;
 		default:
 			return "";
 	}
 }
 
-static const char *apply_specifier(log_item *item, char spec, char *num_buf, size_t num_buf_size) {
+struct log_format_op {
+	struct log_formatter *spec;
+	const char *str;
+	size_t len;
+	size_t width;
+	bool left;
+	char pad;
+};
+
+struct log_format {
+	char *source;
+	size_t count;
+	struct log_format_op ops[];
+};
+
+static struct log_formatter *find_specifier(char spec) {
 	struct log_formatter *f;
-	for (f = default_formatters; f->tag; f++) {
-		if (f->tag != spec) continue;
-		return resolve_specifier(f, item, num_buf, num_buf_size);
-	}
+	for (f = default_formatters; f->tag; f++)
+		if (f->tag == spec) return f;
 	return NULL;
 }
 
 /**
- * @brief Format a log item into a string using a printf-like format specifier.
+ * @brief Compile a format string into a list of literal spans and specifiers.
  * Supported format specifiers:
  *   %%  literal percent sign
  *   %l  log level (DEBUG, INFO, WARNING, ERROR)
@@ -96,64 +132,140 @@ static const char *apply_specifier(log_item *item, char spec, char *num_buf, siz
  *   %F  source function name
  *   %L  source line number
  *   %m  log message content
+ *   %r  time since the first log item, e.g. "+12.345ms"
  *   %Y  year, %M month, %D day, %h hour, %i minute, %s second, %S nanosecond
  *
+ * A specifier may have a minimum width between '%' and the letter, e.g.
+ * "%-7l" pads the level to 7 columns on the right, "%02h" pads the hour
+ * with zeros on the left. Unknown specifiers are copied as is.
+ *
  * If format is NULL, the default format "[%l] %t: %m" is used.
  *
- * @param item   the log item to format (must not be NULL)
  * @param format format string with % specifiers (may be NULL for default)
- * @param crlf   line ending mode: 0 = none, 1 = LF, >1 = CRLF
- * @return newly allocated formatted string (caller must free), or NULL on failure
+ * @return compiled format (free with log_format_free), or NULL on failure
  */
-char* log_formatter(log_item *item, const char *format, int crlf) {
-	size_t cap = 256, len = 0, vlen;
-	char *result, *tmp, num_buf[32];
-	const char *p, *value;
-	if (!item) return NULL;
+log_format* log_format_compile(const char *format) {
+	struct log_format_op *op = NULL;
+	const char *p, *s;
+	log_format *fmt;
+	size_t cnt = 1;
 	if (!format) format = DEFAULT_LOG_FORMAT;
-	p = format;
-	if (!(result = malloc(cap))) return NULL;
-	result[0] = 0;
-	while (*p) if (*p == '%' && *(p + 1)) {
-		p++;
-		if (!(value = apply_specifier(item, *p, num_buf, sizeof(num_buf)))) {
-			num_buf[0] = '%';
-			num_buf[1] = *p;
-			num_buf[2] = 0;
-			value = num_buf;
-		}
-		vlen = strlen(value);
-		while (len + vlen >= cap) {
-			cap *= 2;
-			if (!(tmp = realloc(result, cap))) goto fail;
-			result = tmp;
+	for (p = format; *p; p++) if (*p == '%') cnt += 2;
+	if (!(fmt = malloc(sizeof(log_format) + cnt * sizeof(struct log_format_op))))
+		return NULL;
+	memset(fmt, 0, sizeof(log_format) + cnt * sizeof(struct log_format_op));
+	if (!(fmt->source = strdup(format))) {
+		free(fmt);
+		return NULL;
+	}
+	p = fmt->source;
+	while (*p) {
+		struct log_formatter *spec = NULL;
+		size_t width = 0;
+		bool left = false;
+		char pad = ' ';
+		s = p;
+		if (*p == '%' && p[1]) {
+			p++;
+			if (*p == '-') left = true, p++;
+			if (*p == '0') pad = '0', p++;
+			while (*p >= '0' && *p <= '9') width = width * 10 + (*p++ - '0');
+			if (*p) spec = find_specifier(*p++);
+		} else p++;
+		if (spec) {
+			op = &fmt->ops[fmt->count++];
+			op->spec = spec;
+			op->width = width;
+			op->left = left;
+			op->pad = left ? ' ' : pad;
+			continue;
 		}
-		memcpy(result + len, value, vlen);
-		len += vlen;
-		result[len] = 0;
-		p++;
-	} else {
-		if (len + 1 >= cap) {
-			cap *= 2;
-			if (!(tmp = realloc(result, cap))) goto fail;
-			result = tmp;
+		if (op && !op->spec && op->str + op->len == s) {
+			op->len += p - s;
+			continue;
 		}
-		result[len++] = *p++;
-		result[len] = 0;
+		op = &fmt->ops[fmt->count++];
+		op->str = s;
+		op->len = p - s;
 	}
-	if (crlf > 0) {
-		if (len + 2 >= cap) {
-			cap += 2;
-			if (!(tmp = realloc(result, cap))) goto fail;
-			result = tmp;
+	return fmt;
+}
+
+/**
+ * @brief Free a format compiled by log_format_compile.
+ *
+ * @param fmt the compiled format (safe to pass NULL)
+ */
+void log_format_free(log_format *fmt) {
+	if (!fmt) return;
+	if (fmt->source) free(fmt->source);
+	free(fmt);
+}
+
+static bool buffer_reserve(char **buff, size_t *size, size_t need) {
+	size_t cap = *size > 0 ? *size : 256;
+	char *tmp;
+	if (*buff && need <= *size) return true;
+	while (cap < need) cap *= 2;
+	if (!(tmp = realloc(*buff, cap))) return false;
+	*buff = tmp;
+	*size = cap;
+	return true;
+}
+
+/**
+ * @brief Format a log item with a compiled format.
+ * The line is rendered into a caller owned buffer that grows as needed and
+ * is meant to be reused for every item of a backend.
+ *
+ * @param fmt   the compiled format (must not be NULL)
+ * @param item  the log item to format (must not be NULL)
+ * @param crlf  line ending mode: 0 = none, 1 = LF, >1 = CRLF
+ * @param buff  pointer to the reusable buffer (may point to NULL)
+ * @param size  pointer to the size of the buffer
+ * @param len   receive the length of the formatted line (may be NULL)
+ * @return the formatted line in *buff, or NULL on failure
+ */
+char* log_format_render(
+	log_format *fmt,
+	log_item *item,
+	int crlf,
+	char **buff,
+	size_t *size,
+	size_t *len
+) {
+	size_t pos = 0, vlen, fill, cap;
+	char num_buf[32], *out;
+	const char *value;
+	EFI_TIME time;
+	bool time_valid = false;
+	if (!fmt || !item || !buff || !size) return NULL;
+	out = *buff, cap = out ? *size : 0;
+	for (size_t i = 0; i < fmt->count; i++) {
+		struct log_format_op *op = &fmt->ops[i];
+		if (op->spec && op->spec->time) {
+			if (!time_valid) log_item_time(item, &time), time_valid = true;
+			value = resolve_specifier(op->spec, &time, num_buf, sizeof(num_buf));
+			vlen = strlen(value);
+		} else if (op->spec) {
+			value = resolve_specifier(op->spec, item, num_buf, sizeof(num_buf));
+			vlen = strlen(value);
+		} else value = op->str, vlen = op->len;
+		fill = op->width > vlen ? op->width - vlen : 0;
+		if (pos + vlen + fill + 3 > cap) {
+			if (!buffer_reserve(buff, size, pos + vlen + fill + 3)) return NULL;
+			out = *buff, cap = *size;
 		}
-		if (crlf > 1)
-			result[len++] = '\r';
-		result[len++] = '\n';
-		result[len] = 0;
+		if (fill > 0 && !op->left) memset(out + pos, op->pad, fill), pos += fill;
+		memcpy(out + pos, value, vlen);
+		pos += vlen;
+		if (fill > 0 && op->left) memset(out + pos, op->pad, fill), pos += fill;
 	}
-	return result;
-fail:
-	if (result) free(result);
-	return NULL;
+	if (!out && !buffer_reserve(buff, size, 3)) return NULL;
+	out = *buff;
+	if (crlf > 1) out[pos++] = '\r';
+	if (crlf > 0) out[pos++] = '\n';
+	out[pos] = 0;
+	if (len) *len = pos;
+	return out;
 }
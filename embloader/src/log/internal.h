@@ -13,11 +13,12 @@
 typedef struct log_item log_item;
 typedef struct log_backend log_backend;
 typedef struct log_backend_base log_backend_base;
+typedef struct log_filter log_filter;
+typedef struct log_format log_format;
 
 struct log_item {
 	log_level level;
-	EFI_TIME time;
-	bool log_flushed;
+	uint64_t usec;
 	uint32_t size;
 	int lineno;
 	const char *tag;
@@ -32,6 +33,7 @@ struct log_backend_base {
 	int (*init)(log_backend *backend);
 	int (*deinit)(log_backend *backend);
 	int (*write)(log_backend *backend, log_item *item);
+	int (*sync)(log_backend *backend);
 	size_t ctx_size;
 };
 
@@ -39,6 +41,11 @@ struct log_backend {
 	char *name;
 	log_backend_base *base;
 	confignode *config;
+	log_filter *filter;
+	log_format *format;
+	char *buff;
+	size_t buff_size;
+	uint64_t cursor;
 	void *ctx;
 };
 
@@ -50,14 +57,30 @@ extern log_item* log_item_create(
 	int lineno,
 	const char *content
 );
-extern bool log_append(struct log_item *item);
+extern void log_item_time(log_item *item, EFI_TIME *time);
+extern log_item* log_store_alloc(size_t size);
+extern log_item* log_store_read(uint64_t *cursor);
+#define LOG_STORE_MIN 4096
+extern bool log_store_resize(size_t limit);
+extern void log_flush_to(log_backend *backend, bool force);
 extern void log_flush_all(bool force);
-extern void log_flush_one_to(log_backend *backend, log_item *item, bool force);
 extern void log_flush_fast();
 extern const char *log_level_str(log_level level);
 extern bool log_level_from_str(const char *str, log_level *level);
-extern char* log_formatter(log_item *item, const char *format, int crlf);
-extern bool log_check_filter(log_item *item, confignode *config);
+extern log_format* log_format_compile(const char *format);
+extern void log_format_free(log_format *fmt);
+extern char* log_format_render(
+	log_format *fmt,
+	log_item *item,
+	int crlf,
+	char **buff,
+	size_t *size,
+	size_t *len
+);
+extern char* log_backend_format(log_backend *backend, log_item *item, size_t *len);
+extern log_filter* log_filter_compile(confignode *config);
+extern void log_filter_free(log_filter *filter);
+extern bool log_check_filter(log_item *item, log_filter *filter);
 extern log_backend* log_backend_create(
 	log_backend_base *base,
 	const char *name,
@@ -68,11 +91,11 @@ extern void log_backend_destroy(log_backend *backend);
 extern int log_backend_write(log_backend *backend, log_item *item);
 extern int log_backend_init(log_backend *backend);
 extern int log_backend_deinit(log_backend *backend);
+extern int log_backend_sync(log_backend *backend);
 extern void log_backends_init(confignode *config);
 extern log_backend_base log_backend_stdio;
 extern log_backend_base log_backend_file;
 extern log_backend_base *log_backend_bases[];
-extern list *log_items;
 extern list *log_backends;
 extern size_t log_size_limit;
 extern size_t log_size_cur;
@@ -2,8 +2,8 @@
 
 /**
  * @brief Submit a log message as a pre-formatted string.
- * Creates a log item, appends it to the log store, and triggers a fast flush
- * to all backends.
+ * Creates a log item in the log store and triggers a fast flush to all
+ * backends.
  *
  * @param level    log severity level
  * @param tag      log tag string (may be NULL)
@@ -20,14 +20,9 @@ void log_base_print(
 	int lineno,
 	const char *content
 ) {
-	log_item *item = NULL;
 	if (!content) return;
-	if (!(item = log_item_create(level, tag, file, function, lineno, content))) goto fail;
-	if (!log_append(item)) goto fail;
+	if (!log_item_create(level, tag, file, function, lineno, content)) return;
 	log_flush_fast();
-	return;
-fail:
-	if (item) free(item);
 }
 
 /**
@@ -1,107 +1,209 @@
 #include "internal.h"
 
-list *log_items = NULL;
+#define LOG_RECORD_ALIGN 8
+
+/*
+ * Log items are stored back to back in one preallocated buffer. Positions
+ * are logical byte offsets that only grow, the physical offset is the
+ * position modulo the buffer size. A record never wraps, the space left at
+ * the end of the buffer is skipped and marked with a zero sized item when
+ * it is large enough to hold one.
+ */
+struct log_ring {
+	char *data;
+	size_t size;
+	uint64_t head;
+	uint64_t tail;
+};
+
+static struct log_ring log_ring = {};
 size_t log_size_limit = 1024 * 1024;
 size_t log_size_cur = 0;
 
-static void log_size_limit_check() {
-	list *l;
-	l = list_first(log_items);
-	while (log_size_cur > log_size_limit && log_items && l) {
-		if (!l) break;
-		LIST_DATA_DECLARE(item, l, log_item*);
-		if (item) {
-			log_size_cur -= item->size;
-			list_obj_del(&log_items, l, list_default_free);
+static inline log_item *log_ring_at(struct log_ring *ring, uint64_t pos) {
+	return (log_item*) (ring->data + pos % ring->size);
+}
+
+static uint64_t log_ring_skip(struct log_ring *ring, uint64_t pos) {
+	size_t left;
+	if (pos == ring->head) return pos;
+	left = ring->size - pos % ring->size;
+	if (left < sizeof(log_item) || log_ring_at(ring, pos)->size == 0)
+		pos += left;
+	return pos;
+}
+
+static uint64_t log_ring_next(struct log_ring *ring, uint64_t pos) {
+	pos = log_ring_skip(ring, pos);
+	if (pos == ring->head) return pos;
+	return log_ring_skip(ring, pos + log_ring_at(ring, pos)->size);
+}
+
+static log_item *log_ring_alloc(struct log_ring *ring, size_t size) {
+	uint64_t start = ring->head;
+	size_t left = ring->size - start % ring->size;
+	log_item *item;
+	if (size > ring->size) return NULL;
+	if (left < size) start += left;
+	while (start + size - ring->tail > ring->size) {
+		if (ring->tail == ring->head) {
+			ring->tail = start;
+			break;
 		}
-		l = list_first(log_items);
+		ring->tail = log_ring_next(ring, ring->tail);
 	}
+	if (start != ring->head && left >= sizeof(log_item))
+		log_ring_at(ring, ring->head)->size = 0;
+	item = log_ring_at(ring, start);
+	memset(item, 0, size);
+	item->size = size;
+	ring->head = start + size;
+	return item;
+}
+
+static void log_item_relocate(log_item *dst, log_item *src) {
+	memcpy(dst, src, src->size);
+	#define RELOCATE(field) if (src->field) \
+		dst->field = (char*) dst + (src->field - (char*) src)
+	RELOCATE(tag);
+	RELOCATE(file);
+	RELOCATE(function);
+	RELOCATE(content);
+	#undef RELOCATE
 }
 
 /**
- * @brief Append a log item to the log store.
- * Adds the item to the global log_items list and enforces the size limit
- * by evicting oldest items if necessary.
+ * @brief Resize the log store.
+ * Allocates the buffer on first use. When items are already stored they are
+ * moved to the new buffer, the oldest ones are dropped if they do not fit,
+ * and backend cursors are moved along with their items.
  *
- * @param item the log item to append (must not be NULL, size must be < log_size_limit)
- * @return true on success, false if item is NULL, too large, or allocation fails
+ * @param limit new size of the store in bytes
+ * @return true on success, false if limit is too small or allocation fails
  */
-bool log_append(struct log_item *item) {
-	int ret;
-	if (!item || item->size >= log_size_limit) return false;
-	log_size_limit_check();
-	item->log_flushed = false;
-	ret = list_obj_add_new(&log_items, item);
-	if (ret < 0) return false;
-	log_size_cur += item->size;
-	log_size_limit_check();
+bool log_store_resize(size_t limit) {
+	struct log_ring old = log_ring, ring = {};
+	uint64_t pos;
+	list *b;
+	limit -= limit % LOG_RECORD_ALIGN;
+	if (limit < LOG_STORE_MIN) return false;
+	if (old.data && limit == old.size) return true;
+	if (!(ring.data = malloc(limit))) return false;
+	ring.size = limit;
+	if (old.data) {
+		ring.head = ring.tail = (old.head / limit + 1) * limit;
+		if ((b = list_first(log_backends))) do {
+			LIST_DATA_DECLARE(backend, b, log_backend*);
+			if (!backend) continue;
+			if (backend->cursor < old.tail) backend->cursor = old.tail;
+			backend->cursor = log_ring_skip(&old, backend->cursor);
+		} while ((b = b->next));
+		for (pos = log_ring_skip(&old, old.tail); pos != old.head; pos = log_ring_next(&old, pos)) {
+			log_item *src = log_ring_at(&old, pos), *dst;
+			if (!(dst = log_ring_alloc(&ring, src->size))) continue;
+			log_item_relocate(dst, src);
+			if ((b = list_first(log_backends))) do {
+				LIST_DATA_DECLARE(backend, b, log_backend*);
+				if (backend && backend->cursor == pos)
+					backend->cursor = ring.head - src->size;
+			} while ((b = b->next));
+		}
+		if ((b = list_first(log_backends))) do {
+			LIST_DATA_DECLARE(backend, b, log_backend*);
+			if (!backend || backend->cursor >= ring.tail) continue;
+			backend->cursor = backend->cursor == old.head ? ring.head : ring.tail;
+		} while ((b = b->next));
+		free(old.data);
+	}
+	log_ring = ring;
+	log_size_limit = limit;
+	log_size_cur = ring.head - ring.tail;
 	return true;
 }
 
 /**
- * @brief Flush a single log item to a specific backend.
- * Writes the item to the backend and marks it as flushed.
+ * @brief Allocate a log item in the log store.
+ * The record is carved out of the preallocated buffer, evicting the oldest
+ * items when the store is full. The returned item is zeroed except for its
+ * size and stays valid until it is evicted.
+ *
+ * @param size size of the item including its string data
+ * @return the new item, or NULL if size does not fit in the store
+ */
+log_item* log_store_alloc(size_t size) {
+	log_item *item;
+	size = (size + LOG_RECORD_ALIGN - 1) & ~(size_t) (LOG_RECORD_ALIGN - 1);
+	if (!log_ring.data && !log_store_resize(log_size_limit)) return NULL;
+	if (size >= log_ring.size || size >= UINT32_MAX) return NULL;
+	if (!(item = log_ring_alloc(&log_ring, size))) return NULL;
+	log_size_cur = log_ring.head - log_ring.tail;
+	return item;
+}
+
+/**
+ * @brief Read the next log item after a cursor.
+ * Cursors pointing at evicted items are moved to the oldest stored item.
+ *
+ * @param cursor read position, advanced past the returned item
+ * @return the next item, or NULL if the cursor reached the newest item
+ */
+log_item* log_store_read(uint64_t *cursor) {
+	log_item *item;
+	uint64_t pos = *cursor;
+	if (!log_ring.data) return NULL;
+	if (pos < log_ring.tail) pos = log_ring.tail;
+	pos = log_ring_skip(&log_ring, pos);
+	if (pos == log_ring.head) {
+		*cursor = pos;
+		return NULL;
+	}
+	item = log_ring_at(&log_ring, pos);
+	*cursor = pos + item->size;
+	return item;
+}
+
+/**
+ * @brief Flush stored log items to a specific backend.
+ * Writes every item after the cursor of the backend.
  *
- * @param backend the log backend to write to
- * @param item    the log item to flush (safe to pass NULL)
- * @param force   if true, flush even if already marked as flushed
+ * @param backend the log backend to flush to
+ * @param force   if true, rewind the cursor and write all stored items
  */
-void log_flush_one_to(log_backend *backend, log_item *item, bool force) {
-	if (!item) return;
-	if (item->log_flushed && !force) return;
-	log_backend_write(backend, item);
-	item->log_flushed = true;
+void log_flush_to(log_backend *backend, bool force) {
+	log_item *item;
+	if (!backend) return;
+	if (force) backend->cursor = log_ring.tail;
+	while ((item = log_store_read(&backend->cursor)))
+		log_backend_write(backend, item);
 }
 
 /**
- * @brief Flush all log items to all registered backends.
- * Iterates through every log item and writes unflushed ones to all backends.
- * Also recalculates the current log size.
+ * @brief Flush stored log items to all registered backends.
  *
- * @param force if true, flush all items regardless of their flushed state
+ * @param force if true, write all stored items regardless of the cursors
  */
 void log_flush_all(bool force) {
-	list *b, *i;
-	log_size_cur = 0;
-	if ((i = list_first(log_items))) do {
-		LIST_DATA_DECLARE(item, i, log_item*);
-		if (!item) continue;
-		log_size_cur += item->size;
-		if (item->log_flushed && !force) continue;
-		if ((b = list_first(log_backends))) do {
-			LIST_DATA_DECLARE(backend, b, log_backend*);
-			if (log_backend_write(backend, item) < 0) continue; 
-			item->log_flushed = true;
-		} while ((b = b->next));
-	} while ((i = i->next));
+	list *b;
+	if ((b = list_first(log_backends))) do {
+		LIST_DATA_DECLARE(backend, b, log_backend*);
+		log_flush_to(backend, force);
+	} while ((b = b->next));
 }
 
 /**
- * @brief Fast-path flush of recently added log items to all backends.
- * Scans from the tail of the log list to find the first batch of unflushed
- * items, then writes only those items to all registered backends. This is
- * more efficient than log_flush_all for the common case of flushing newly
- * appended items.
+ * @brief Flush newly appended log items to all backends.
+ * Each backend continues from its own cursor, so only the items it has not
+ * seen yet are written. Items logged by a backend while it is being written
+ * to are picked up by the running flush instead of recursing.
  */
 void log_flush_fast() {
-	list *b, *i, *s = NULL;
-	if ((i = list_last(log_items))) do {
-		LIST_DATA_DECLARE(item, i, log_item*);
-		if (!item) continue;
-		if (item->log_flushed) break;
-		s = i;
-	} while ((i = i->prev));
-	if (!s) s = list_first(log_items);
-	if (!s) return;
-	i = s;
+	static bool flushing = false;
+	uint64_t head;
+	if (flushing) return;
+	flushing = true;
 	do {
-		LIST_DATA_DECLARE(item, i, log_item*);
-		if (!item) continue;
-		if (item->log_flushed) break;
-		if ((b = list_first(log_backends))) do {
-			LIST_DATA_DECLARE(backend, b, log_backend*);
-			if (log_backend_write(backend, item) < 0) continue; 
-			item->log_flushed = true;
-		} while ((b = b->next));
-	} while ((i = i->next));
+		head = log_ring.head;
+		log_flush_all(false);
+	} while (head != log_ring.head);
+	flushing = false;
 }
@@ -0,0 +1,208 @@
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Guid/FileInfo.h>
+#include "crc32.h"
+#include "file-utils.h"
+#include "efi-utils.h"
+#include "embloader.h"
+#include "log.h"
+
+#define CONFIG_CACHE_FILE "config.cache"
+#define CONFIG_CACHE_MAGIC 0x48434345 /* "ECCH" */
+#define CONFIG_CACHE_SCRATCH SIZE_64KB
+
+struct config_cache_source {
+	uint32_t exists;
+	uint32_t crc;
+	uint64_t size;
+	EFI_TIME mtime;
+};
+
+struct config_cache_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t sources;
+	uint32_t reserved;
+	uint64_t image_size;
+};
+
+/* every file read by embloader_load_configs */
+static const char *config_cache_files[] = {
+	"config.static.yaml",
+	"config.static.yml",
+	"config.static.json",
+	"config.static.conf",
+	"dtbo.txt",
+	"cmdline.txt",
+	"config.dynamic.yaml",
+	"config.dynamic.yml",
+	"config.dynamic.json",
+	"config.dynamic.conf",
+};
+
+#define CONFIG_CACHE_SOURCES ARRAY_SIZE(config_cache_files)
+
+static uint32_t config_cache_version() {
+	static const char version[] = EMBLOADER_VERSION;
+	return s_crc32((void*) version, sizeof(version) - 1);
+}
+
+static void config_cache_source_crc(const void *buffer, size_t len, void *data) {
+	uint32_t *crc = data;
+	*crc = s_crc32_update(*crc, buffer, len);
+}
+
+static bool config_cache_source_get(const char *name, struct config_cache_source *src) {
+	EFI_STATUS status;
+	EFI_FILE_PROTOCOL *file = NULL;
+	EFI_FILE_INFO *info = NULL;
+	static UINT8 scratch[CONFIG_CACHE_SCRATCH];
+	bool ret = false;
+	memset(src, 0, sizeof(struct config_cache_source));
+	status = efi_open(g_embloader.dir.dir, &file, name, EFI_FILE_MODE_READ, 0);
+	if (status == EFI_NOT_FOUND) return true;
+	if (EFI_ERROR(status) || !file) return false;
+	if (EFI_ERROR(efi_file_get_info(file, &info)) || !info) goto done;
+	src->exists = 1;
+	src->size = info->FileSize;
+	memcpy(&src->mtime, &info->ModificationTime, sizeof(EFI_TIME));
+	src->mtime.Pad1 = 0, src->mtime.Pad2 = 0;
+	if (info->FileSize > 0 && EFI_ERROR(efi_file_stream_read(
+		file, 0, info->FileSize, scratch, sizeof(scratch),
+		config_cache_source_crc, &src->crc
+	))) goto done;
+	ret = true;
+done:
+	if (info) FreePool(info);
+	file->Close(file);
+	return ret;
+}
+
+/* source files do not change while embloader runs, read them only once */
+static bool config_cache_sources(struct config_cache_source *srcs) {
+	static struct config_cache_source cached[CONFIG_CACHE_SOURCES];
+	static bool valid = false;
+	if (!valid) {
+		for (size_t i = 0; i < CONFIG_CACHE_SOURCES; i++)
+			if (!config_cache_source_get(config_cache_files[i], &cached[i]))
+				return false;
+		valid = true;
+	}
+	memcpy(srcs, cached, sizeof(cached));
+	return true;
+}
+
+/**
+ * @brief Checksum the state of every config source file
+ *
+ * Covers existence, size, modification time and content CRC of each file
+ * read by embloader_load_configs.
+ *
+ * @param crc receive the checksum
+ * @return true on success
+ */
+bool embloader_config_checksum(uint32_t *crc) {
+	struct config_cache_source srcs[CONFIG_CACHE_SOURCES];
+	if (!crc || !g_embloader.dir.dir) return false;
+	if (!config_cache_sources(srcs)) return false;
+	*crc = s_crc32(srcs, sizeof(srcs));
+	return true;
+}
+
+/**
+ * @brief Load the merged configuration from the binary config cache
+ *
+ * The cache is only used when every source file still has the same size,
+ * modification time and checksum as when the cache was written, and the
+ * embloader version is unchanged.
+ *
+ * @return true on cache hit, g_embloader.config is replaced by the cache
+ */
+bool embloader_config_cache_load() {
+	bool ret = false;
+	void *data = NULL;
+	size_t len = 0;
+	const char *reason = "not found";
+	struct config_cache_source srcs[CONFIG_CACHE_SOURCES];
+	struct config_cache_header *hdr;
+	size_t off = sizeof(struct config_cache_header) + sizeof(srcs);
+	confignode *cfg;
+	if (!g_embloader.dir.dir) return false;
+	if (!efi_file_exists(g_embloader.dir.dir, CONFIG_CACHE_FILE)) goto done;
+	reason = "read failed";
+	if (EFI_ERROR(efi_file_open_read_all(
+		g_embloader.dir.dir, CONFIG_CACHE_FILE, &data, &len
+	)) || !data) goto done;
+	reason = "invalid cache";
+	if (len < off) goto done;
+	hdr = data;
+	if (hdr->magic != CONFIG_CACHE_MAGIC) goto done;
+	if (hdr->sources != CONFIG_CACHE_SOURCES) goto done;
+	if (hdr->image_size != len - off) goto done;
+	reason = "embloader version changed";
+	if (hdr->version != config_cache_version()) goto done;
+	reason = "source files changed";
+	if (!config_cache_sources(srcs)) goto done;
+	if (memcmp((uint8_t*) data + sizeof(struct config_cache_header), srcs, sizeof(srcs)) != 0)
+		goto done;
+	reason = "invalid cache image";
+	cfg = configfile_binary_load(
+		(uint8_t*) data + off, hdr->image_size, CONFIGFILE_LOAD_ARENA
+	);
+	if (!cfg) goto done;
+	confignode_clean(g_embloader.config);
+	g_embloader.config = cfg;
+	ret = true;
+done:
+	if (data) free(data);
+	if (ret) log_info("config cache hit, loaded %s", CONFIG_CACHE_FILE);
+	else log_info("config cache miss: %s", reason);
+	return ret;
+}
+
+/**
+ * @brief Save the merged configuration into the binary config cache
+ *
+ * Called after all config files were parsed on a cache miss. Can be
+ * disabled with config.cache.
+ */
+void embloader_config_cache_save() {
+	EFI_STATUS status;
+	EFI_FILE_PROTOCOL *file = NULL;
+	struct config_cache_source srcs[CONFIG_CACHE_SOURCES];
+	struct config_cache_header hdr;
+	void *image = NULL, *data = NULL;
+	size_t len = 0, off = sizeof(hdr) + sizeof(srcs);
+	if (!g_embloader.dir.dir || !g_embloader.config) return;
+	if (!confignode_path_get_bool(g_embloader.config, "config.cache", true, NULL)) return;
+	if (!config_cache_sources(srcs)) return;
+	if (!(image = configfile_binary_save(g_embloader.config, &len))) return;
+	if (!(data = malloc(off + len))) goto done;
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = CONFIG_CACHE_MAGIC;
+	hdr.version = config_cache_version();
+	hdr.sources = CONFIG_CACHE_SOURCES;
+	hdr.image_size = len;
+	memcpy(data, &hdr, sizeof(hdr));
+	memcpy((uint8_t*) data + sizeof(hdr), srcs, sizeof(srcs));
+	memcpy((uint8_t*) data + off, image, len);
+	status = efi_open(
+		g_embloader.dir.dir, &file, CONFIG_CACHE_FILE,
+		EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE, 0
+	);
+	if (EFI_ERROR(status) || !file) {
+		log_debug(
+			"open %s for write failed: %s",
+			CONFIG_CACHE_FILE, efi_status_to_string(status)
+		);
+		goto done;
+	}
+	efi_file_set_size(file, 0);
+	if (!efi_file_write_all(file, data, off + len))
+		log_warning("write %s failed", CONFIG_CACHE_FILE);
+	else log_debug("saved config cache %s", CONFIG_CACHE_FILE);
+	file->Close(file);
+done:
+	if (data) free(data);
+	free(image);
+}
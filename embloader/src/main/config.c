@@ -12,20 +12,22 @@ bool embloader_load_config_one(const char *name) {
 		log_warning("unknown config file type for %s", name);
 		return false;
 	}
-	confignode *newcfg = configfile_load_efi_file_path(type, g_embloader.dir.dir, name);
+	confignode *newcfg = configfile_load_efi_file_path_ex(
+		type, g_embloader.dir.dir, name, CONFIGFILE_LOAD_ARENA
+	);
 	if (!newcfg) {
 		log_warning("Failed to parse config file %s", name);
 		return false;
 	}
-	if (!confignode_merge(g_embloader.config, newcfg))
+	if (!confignode_merge_steal(g_embloader.config, newcfg))
 		log_warning("Failed to merge config file %s", name);
-	confignode_clean(newcfg);
 	log_info("Loaded config file %s", name);
 	return true;
 }
 
 bool embloader_load_configs() {
 	int cnt = 0;
+	if (embloader_config_cache_load()) return true;
 	if (embloader_load_config_one("config.static.yaml")) cnt++;
 	if (embloader_load_config_one("config.static.yml")) cnt++;
 	if (embloader_load_config_one("config.static.json")) cnt++;
@@ -36,8 +38,10 @@ bool embloader_load_configs() {
 	if (embloader_load_config_one("config.dynamic.yml")) cnt++;
 	if (embloader_load_config_one("config.dynamic.json")) cnt++;
 	if (embloader_load_config_one("config.dynamic.conf")) cnt++;
-	if (cnt > 0) log_info("Loaded %d configuration files", cnt);
-	else log_warning("No configuration files loaded");
+	if (cnt > 0) {
+		log_info("Loaded %d configuration files", cnt);
+		embloader_config_cache_save();
+	} else log_warning("No configuration files loaded");
 	return cnt > 0;
 }
 
@@ -1,6 +1,144 @@
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/BaseLib.h>
+#include "crc32.h"
 #include "embloader.h"
+#include "variables.h"
+#include "efi-utils.h"
 #include "log.h"
 
+#define DEVICE_CACHE_VAR "DeviceCache"
+#define DEVICE_CACHE_MAGIC 0x43444545 /* "EEDC" */
+
+/* followed by the device name and each profile as NUL-terminated strings */
+struct device_cache_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t smbios;
+	uint32_t config;
+	uint32_t vendor;
+	uint32_t revision;
+	uint32_t profiles;
+	uint32_t size;
+};
+
+/* everything that can change the result of device matching */
+#define DEVICE_CACHE_FINGERPRINT offsetof(struct device_cache_header, profiles)
+
+static bool device_cache_fingerprint(struct device_cache_header *hdr) {
+	static const char version[] = EMBLOADER_VERSION;
+	memset(hdr, 0, sizeof(struct device_cache_header));
+	if (!g_embloader.smbios_crc) return false;
+	if (!embloader_config_checksum(&hdr->config)) return false;
+	hdr->magic = DEVICE_CACHE_MAGIC;
+	hdr->version = s_crc32((void*) version, sizeof(version) - 1);
+	hdr->smbios = g_embloader.smbios_crc;
+	if (gST->FirmwareVendor) hdr->vendor = s_crc32(
+		gST->FirmwareVendor, StrSize(gST->FirmwareVendor)
+	);
+	hdr->revision = gST->FirmwareRevision;
+	return true;
+}
+
+/**
+ * @brief Restore the device chosen on a previous boot
+ *
+ * The cache is only used when SMBIOS tables, config source files, firmware
+ * and embloader version are the same as when it was written.
+ *
+ * @return true on cache hit, device name and profiles are set
+ */
+static bool device_cache_load() {
+	struct device_cache_header fp, *hdr;
+	const char *reason = "not found";
+	list *profiles = NULL;
+	char *name = NULL, *str, *end;
+	void *data = NULL;
+	size_t len = 0;
+	bool ret = false;
+	if (!device_cache_fingerprint(&fp)) return false;
+	if (EFI_ERROR(efivar_get_raw(
+		&efivar_embloader_guid, DEVICE_CACHE_VAR, &data, &len
+	)) || !data) goto done;
+	reason = "invalid cache";
+	if (len < sizeof(struct device_cache_header)) goto done;
+	hdr = data;
+	if (hdr->size != len - sizeof(struct device_cache_header)) goto done;
+	reason = "fingerprint changed";
+	if (memcmp(hdr, &fp, DEVICE_CACHE_FINGERPRINT) != 0) goto done;
+	reason = "invalid cache";
+	str = (char*) data + sizeof(struct device_cache_header);
+	end = str + hdr->size;
+	if (hdr->size == 0 || end[-1] != 0) goto done;
+	if (!(name = strdup(str))) goto done;
+	str += strlen(str) + 1;
+	for (uint32_t i = 0; i < hdr->profiles; i++) {
+		if (str >= end) goto done;
+		char *v = strdup(str);
+		if (!v) goto done;
+		log_debug("Pick profile %s", v);
+		list_obj_add_new(&profiles, v);
+		str += strlen(str) + 1;
+	}
+	log_info("Found matched device from cache: %s", name);
+	if (g_embloader.device_name)
+		free(g_embloader.device_name);
+	g_embloader.device_name = name;
+	name = NULL;
+	list_obj_add(&g_embloader.profiles, profiles);
+	profiles = NULL;
+	ret = true;
+done:
+	if (!ret) log_debug("device cache miss: %s", reason);
+	if (profiles) list_free_all_def(profiles);
+	if (name) free(name);
+	if (data) free(data);
+	return ret;
+}
+
+/**
+ * @brief Remember the chosen device for the next boot
+ */
+static void device_cache_save() {
+	struct device_cache_header hdr;
+	EFI_STATUS status;
+	size_t len;
+	char *data, *str;
+	list *p;
+	if (!g_embloader.device_name) return;
+	if (!device_cache_fingerprint(&hdr)) return;
+	hdr.size = strlen(g_embloader.device_name) + 1;
+	if ((p = list_first(g_embloader.profiles))) do {
+		LIST_DATA_DECLARE(profile, p, char*);
+		if (!profile) continue;
+		hdr.size += strlen(profile) + 1;
+		hdr.profiles++;
+	} while ((p = p->next));
+	if (!(data = malloc(sizeof(hdr) + hdr.size))) return;
+	memcpy(data, &hdr, sizeof(hdr));
+	str = data + sizeof(hdr);
+	len = strlen(g_embloader.device_name) + 1;
+	memcpy(str, g_embloader.device_name, len);
+	str += len;
+	if ((p = list_first(g_embloader.profiles))) do {
+		LIST_DATA_DECLARE(profile, p, char*);
+		if (!profile) continue;
+		len = strlen(profile) + 1;
+		memcpy(str, profile, len);
+		str += len;
+	} while ((p = p->next));
+	status = efivar_set_raw(
+		&efivar_embloader_guid, DEVICE_CACHE_VAR,
+		data, sizeof(hdr) + hdr.size,
+		EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS
+	);
+	if (EFI_ERROR(status)) log_warning(
+		"save device cache failed: %s",
+		efi_status_to_string(status)
+	);
+	else log_debug("saved device cache for %s", g_embloader.device_name);
+	free(data);
+}
+
 static bool embloader_match_device(confignode *node) {
 	if (!node) return false;
 	char *name = confignode_path_get_string(node, "name", NULL, NULL);
@@ -25,11 +163,18 @@ fail:
 }
 
 bool embloader_choose_device() {
+	bool cache = confignode_path_get_bool(
+		g_embloader.config, "config.device-cache", true, NULL
+	);
+	if (cache && device_cache_load()) return true;
 	confignode *devices = confignode_path_lookup(
 		g_embloader.config, "devices", false
 	);
 	if (!devices) return false;
-	confignode_foreach(dev, devices)
-		if (embloader_match_device(dev.node)) return true;
+	confignode_foreach(dev, devices) {
+		if (!embloader_match_device(dev.node)) continue;
+		if (cache) device_cache_save();
+		return true;
+	}
 	return false;
 }
@@ -10,6 +10,7 @@
 #include "bootmenu.h"
 #include "sdboot.h"
 #include "configfile.h"
+#include "file-utils.h"
 #include "ticks.h"
 #include "log.h"
 
@@ -45,6 +46,10 @@ EFI_STATUS EFIAPI efi_main(
 	find_embloader_folder(&g_embloader.dir);
 	if (g_embloader.dir.dir && !embloader_load_configs())
 		log_warning("no config files loaded");
+	efi_file_tune_setup(
+		confignode_path_get_bool(g_embloader.config, "io.tune-chunk", true, NULL),
+		confignode_path_get_bool(g_embloader.config, "io.tune-persist", false, NULL)
+	);
 	if (confignode_path_get_bool(g_embloader.config, "log.print-config", true, NULL)) {
 		log_debug("Final configuration:");
 		confignode_print(g_embloader.config, config_print);
@@ -63,5 +68,6 @@ EFI_STATUS EFIAPI efi_main(
 	sdboot_boot_load_menu();
 	EFI_STATUS status = embloader_show_menu();
 	log_info("exiting embloader");
+	log_sync();
 	return status;
 }
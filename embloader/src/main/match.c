@@ -8,90 +8,271 @@
 #include "regexp.h"
 #include "log.h"
 
-static int compare_versions(const char *v1, const char *v2) {
-	char *s1 = strdup(v1), *s2 = strdup(v2);
-	char *saveptr1, *saveptr2;
-	char *token1 = strtok_r(s1, ".", &saveptr1);
-	char *token2 = strtok_r(s2, ".", &saveptr2);
-	int result = 0;
-	while (token1 && token2) {
-		int n1 = atoi(token1);
-		int n2 = atoi(token2);
-		if (n1 != n2) {
-			result = (n1 > n2) ? 1 : -1;
-			break;
-		}
-		token1 = strtok_r(NULL, ".", &saveptr1);
-		token2 = strtok_r(NULL, ".", &saveptr2);
+typedef enum match_oper {
+	MATCH_INVALID = 0,
+	MATCH_EQUALS,
+	MATCH_NOTEQ,
+	MATCH_CONTAINS,
+	MATCH_REGEXP,
+	MATCH_GREATER,
+	MATCH_LESS,
+	MATCH_GREATER_EQUALS,
+	MATCH_LESS_EQUALS,
+	MATCH_OLDER,
+	MATCH_NEWER,
+} match_oper;
+
+static const struct {
+	const char *name;
+	match_oper oper;
+} match_opers[] = {
+	{ "equals",         MATCH_EQUALS         },
+	{ "noteq",          MATCH_NOTEQ          },
+	{ "contains",       MATCH_CONTAINS       },
+	{ "regexp",         MATCH_REGEXP         },
+	{ "greater",        MATCH_GREATER        },
+	{ "less",           MATCH_LESS           },
+	{ "greater-equals", MATCH_GREATER_EQUALS },
+	{ "less-equals",    MATCH_LESS_EQUALS    },
+	{ "older",          MATCH_OLDER          },
+	{ "newer",          MATCH_NEWER          },
+	{ NULL,             MATCH_INVALID        },
+};
+
+struct match_version {
+	size_t count;
+	int *parts;
+};
+
+struct match_rule {
+	match_oper oper;
+	const char *name;
+	const char *field;
+	const char *value;
+	const char *field_value;
+	Reprog *regex;
+	struct match_version field_ver;
+	struct match_version value_ver;
+};
+
+/*
+ * compiled form of one match array or rule, evaluated without touching the
+ * tree. Rules borrow strings from the config and sysinfo trees, so every
+ * program is dropped as soon as any tree is modified.
+ */
+struct match_program {
+	confignode *node;
+	size_t count;
+	struct match_rule rules[];
+};
+
+static list *match_programs = NULL;
+static uint64_t match_programs_gen = 0;
+
+static bool version_split(const char *str, struct match_version *ver) {
+	const char *p;
+	size_t cnt = 0;
+	memset(ver, 0, sizeof(struct match_version));
+	for (p = str; *p; p++) {
+		if (*p == '.') continue;
+		cnt++;
+		p += strcspn(p, ".");
+		if (!*p) break;
 	}
-	if (result == 0) {
-		if (token1) result = 1;
-		else if (token2) result = -1;
+	if (cnt == 0) return true;
+	if (!(ver->parts = malloc(cnt * sizeof(int)))) return false;
+	for (p = str; *p; p++) {
+		if (*p == '.') continue;
+		ver->parts[ver->count++] = atoi(p);
+		p += strcspn(p, ".");
+		if (!*p) break;
 	}
-	free(s1);
-	free(s2);
-	return result;
+	return true;
 }
 
-bool embloader_try_match(confignode *node) {
-	char *field_value = NULL;
-	bool match = false;
-	if (!node) return false;
+static int compare_versions(struct match_version *v1, struct match_version *v2) {
+	size_t i;
+	for (i = 0; i < v1->count && i < v2->count; i++)
+		if (v1->parts[i] != v2->parts[i])
+			return v1->parts[i] > v2->parts[i] ? 1 : -1;
+	if (i < v1->count) return 1;
+	if (i < v2->count) return -1;
+	return 0;
+}
+
+static void match_rule_free(struct match_rule *rule) {
+	if (rule->regex) regexp_free(rule->regex);
+	if (rule->field_ver.parts) free(rule->field_ver.parts);
+	if (rule->value_ver.parts) free(rule->value_ver.parts);
+	memset(rule, 0, sizeof(struct match_rule));
+}
+
+/**
+ * @brief Compile a match rule node
+ *
+ * Looks up the operator, resolves the field in sysinfo and prepares the
+ * regexp or version components, a rule that fails to compile never matches.
+ *
+ * @param rule rule to fill
+ * @param node match rule node with field, oper and value
+ */
+static void match_rule_compile(struct match_rule *rule, confignode *node) {
+	const char *error = NULL;
 	char buff[256];
+	memset(rule, 0, sizeof(struct match_rule));
 	if (confignode_path_get(node, buff, sizeof(buff)))
-		log_debug("match node %s", buff);
-	if (!confignode_is_type(node, CONFIGNODE_TYPE_MAP)) return false;
-	char *field = confignode_path_get_string(node, "field", NULL, NULL);
-	char *oper = confignode_path_get_string(node, "oper", NULL, NULL);
-	char *value = confignode_path_get_string(node, "value", NULL, NULL);
-	if (!field || !oper || !value) {
+		log_debug("compile match node %s", buff);
+	if (!confignode_is_type(node, CONFIGNODE_TYPE_MAP)) return;
+	rule->field = confignode_path_get_cstr(node, "field", NULL, NULL);
+	rule->value = confignode_path_get_cstr(node, "value", NULL, NULL);
+	rule->name = confignode_path_get_cstr(node, "oper", NULL, NULL);
+	if (!rule->field || !rule->name || !rule->value) {
 		log_warning("missing field/oper/value");
-		goto fail;
+		return;
+	}
+	for (size_t i = 0; match_opers[i].name; i++) {
+		if (strcasecmp(rule->name, match_opers[i].name) != 0) continue;
+		rule->oper = match_opers[i].oper;
+		break;
 	}
-	log_debug("try match: '%s' %s '%s'", field, oper, value);
-	if (!g_embloader.sysinfo) goto fail;
-	;
-	if (!(field_value = confignode_path_get_string(
-		g_embloader.sysinfo, field, NULL, NULL
-	))){
-		log_debug("field '%s' not found", field);
-		goto fail;
+	if (rule->oper == MATCH_INVALID) {
+		log_warning("unknown oper: %s", rule->name);
+		return;
+	}
+	if (g_embloader.sysinfo) rule->field_value = confignode_path_get_cstr(
+		g_embloader.sysinfo, rule->field, NULL, NULL
+	);
+	if (!rule->field_value) return;
+	switch (rule->oper) {
+		case MATCH_REGEXP:
+			rule->regex = regexp_comp(rule->value, REG_ICASE, &error);
+			if (!rule->regex) {
+				log_warning("bad regexp '%s': %s", rule->value, error ? error : "unknown");
+				rule->oper = MATCH_INVALID;
+			}
+			break;
+		case MATCH_OLDER:
+		case MATCH_NEWER:
+			if (!version_split(rule->field_value, &rule->field_ver) ||
+				!version_split(rule->value, &rule->value_ver)) {
+				match_rule_free(rule);
+				rule->oper = MATCH_INVALID;
+			}
+			break;
+		default:;
+	}
+}
+
+static bool match_rule_eval(struct match_rule *rule) {
+	const char *v = rule->field_value;
+	bool match = false;
+	if (rule->oper == MATCH_INVALID) return false;
+	log_debug("try match: '%s' %s '%s'", rule->field, rule->name, rule->value);
+	if (!v) {
+		log_debug("field '%s' not found", rule->field);
+		return false;
+	}
+	log_debug("field '%s' value: '%s'", rule->field, v);
+	switch (rule->oper) {
+		case MATCH_EQUALS:         match = strcasecmp(v, rule->value) == 0; break;
+		case MATCH_NOTEQ:          match = strcasecmp(v, rule->value) != 0; break;
+		case MATCH_CONTAINS:       match = strcasestr(v, rule->value) != NULL; break;
+		case MATCH_REGEXP:         match = regexp_exec(rule->regex, v, NULL, 0) == 0; break;
+		case MATCH_GREATER:        match = strcasecmp(v, rule->value) > 0; break;
+		case MATCH_LESS:           match = strcasecmp(v, rule->value) < 0; break;
+		case MATCH_GREATER_EQUALS: match = strcasecmp(v, rule->value) >= 0; break;
+		case MATCH_LESS_EQUALS:    match = strcasecmp(v, rule->value) <= 0; break;
+		case MATCH_OLDER:          match = compare_versions(&rule->field_ver, &rule->value_ver) < 0; break;
+		case MATCH_NEWER:          match = compare_versions(&rule->field_ver, &rule->value_ver) > 0; break;
+		default:;
 	}
-	log_debug("field '%s' value: '%s'", field, field_value);
-	if (strcasecmp(oper, "equals") == 0) {
-		match = (strcasecmp(field_value, value) == 0);
-	} else if (strcasecmp(oper, "noteq") == 0) {
-		match = (strcasecmp(field_value, value) != 0);
-	} else if (strcasecmp(oper, "contains") == 0) {
-		match = (strcasestr(field_value, value) != NULL);
-	} else if (strcasecmp(oper, "regexp") == 0) {
-		match = (regexp_match(value, field_value, REG_ICASE) == 1);
-	} else if (strcasecmp(oper, "greater") == 0) {
-		match = (strcasecmp(field_value, value) > 0);
-	} else if (strcasecmp(oper, "less") == 0) {
-		match = (strcasecmp(field_value, value) < 0);
-	} else if (strcasecmp(oper, "greater-equals") == 0) {
-		match = (strcasecmp(field_value, value) >= 0);
-	} else if (strcasecmp(oper, "less-equals") == 0) {
-		match = (strcasecmp(field_value, value) <= 0);
-	} else if (strcasecmp(oper, "older") == 0) {
-		match = (compare_versions(field_value, value) < 0);
-	} else if (strcasecmp(oper, "newer") == 0) {
-		match = (compare_versions(field_value, value) > 0);
-	} else log_warning("unknown oper: %s", oper);
 	log_debug("match result: %s", match ? "true" : "false");
-fail:
-	if (field) free(field);
-	if (oper) free(oper);
-	if (value) free(value);
-	if (field_value) free(field_value);
 	return match;
 }
 
-bool embloader_try_matches(confignode *node) {
-	if (!confignode_is_type(node, CONFIGNODE_TYPE_ARRAY)) return false;
-	confignode_foreach(sub, node)
-		if (!embloader_try_match(sub.node))
+static int match_program_free(void *data) {
+	struct match_program *prog = data;
+	if (!prog) return -1;
+	for (size_t i = 0; i < prog->count; i++)
+		match_rule_free(&prog->rules[i]);
+	free(prog);
+	return 0;
+}
+
+static void match_programs_check() {
+	uint64_t gen = confignode_get_generation();
+	if (gen == match_programs_gen) return;
+	if (match_programs) list_free_all(match_programs, match_program_free);
+	match_programs = NULL;
+	match_programs_gen = gen;
+}
+
+/**
+ * @brief Get the compiled program of a match array or a single rule
+ *
+ * Programs are looked up by node and config generation, the cache is
+ * flushed whenever a config tree changes, including changes made by
+ * sysinfo resolvers while a program is compiled.
+ *
+ * @param node ARRAY node of match rules, or MAP node of one rule
+ * @return the compiled program, or NULL on allocation failure
+ */
+static struct match_program *match_program_get(confignode *node) {
+	struct match_program *prog;
+	list *p;
+	size_t i = 0, cnt;
+	match_programs_check();
+	if ((p = list_first(match_programs))) do {
+		LIST_DATA_DECLARE(item, p, struct match_program*);
+		if (item && item->node == node) return item;
+	} while ((p = p->next));
+	cnt = confignode_is_type(node, CONFIGNODE_TYPE_ARRAY) ?
+		confignode_array_len(node) : 1;
+	prog = malloc(sizeof(struct match_program) + cnt * sizeof(struct match_rule));
+	if (!prog) return NULL;
+	memset(prog, 0, sizeof(struct match_program));
+	prog->node = node;
+	if (confignode_is_type(node, CONFIGNODE_TYPE_ARRAY)) {
+		confignode_foreach(sub, node) {
+			if (i >= cnt) break;
+			match_rule_compile(&prog->rules[i++], sub.node);
+		}
+	} else match_rule_compile(&prog->rules[i++], node);
+	prog->count = i;
+	match_programs_check();
+	if (list_obj_add_new(&match_programs, prog) != 0) {
+		match_program_free(prog);
+		return NULL;
+	}
+	return prog;
+}
+
+static bool match_program_eval(struct match_program *prog) {
+	for (size_t i = 0; i < prog->count; i++)
+		if (!match_rule_eval(&prog->rules[i]))
 			return false;
 	return true;
 }
+
+bool embloader_try_match(confignode *node) {
+	struct match_program *prog;
+	if (!node) return false;
+	if (!(prog = match_program_get(node))) return false;
+	return match_program_eval(prog);
+}
+
+/**
+ * @brief Evaluate a match array
+ *
+ * The array is compiled on first use and the compiled rules are reused by
+ * later calls for the same node until any config tree is modified.
+ *
+ * @param node ARRAY node of match rules
+ * @return true if all rules matched
+ */
+bool embloader_try_matches(confignode *node) {
+	struct match_program *prog;
+	if (!confignode_is_type(node, CONFIGNODE_TYPE_ARRAY)) return false;
+	if (!(prog = match_program_get(node))) return false;
+	return match_program_eval(prog);
+}
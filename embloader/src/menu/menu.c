@@ -30,10 +30,9 @@ bool embloader_menu_is_complete() {
 
 static bool loader_filter_profiles(confignode *node, const char *path, bool dir) {
 	confignode_path_foreach(iter, node, path) {
-		char *profile = confignode_value_get_string(iter.node, NULL, NULL);
+		const char *profile = confignode_value_get_cstr(iter.node, NULL, NULL);
 		if (!profile) continue;
 		bool have = list_search_string(g_embloader.profiles, profile) != NULL;
-		free(profile);
 		if (have != dir) return false;
 	}
 	return true;
@@ -238,10 +237,13 @@ EFI_STATUS embloader_show_menu() {
 		if (embloader_menu_is_complete()) {
 			uint64_t flags = 0;
 			embloader_loader *loader = NULL;
+			embloader_prefetch_start();
 			status = embloader_menu_start(&loader, &flags);
+			embloader_prefetch_discard(loader);
 			if (EFI_ERROR(status)) return status;
 			if (!loader) continue;
 			status = embloader_try_boot(loader, flags);
+			embloader_prefetch_discard(NULL);
 			printf("Press any key to continue...\n");
 			efi_wait_any_key(gST->ConIn);
 		} else {
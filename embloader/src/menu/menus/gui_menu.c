@@ -476,6 +476,7 @@ EFI_STATUS embloader_gui_menu_start(embloader_loader **selected, uint64_t *flags
 	EFI_GRAPHICS_OUTPUT_BLT_PIXEL px;
 	struct gui_menu_ctx ctx;
 	EFI_STATUS status;
+	UINTN elapsed = 0;
 	if (flags) *flags = 0;
 	if (!selected) return EFI_INVALID_PARAMETER;
 	memset(&ctx, 0, sizeof(ctx));
@@ -499,8 +500,9 @@ EFI_STATUS embloader_gui_menu_start(embloader_loader **selected, uint64_t *flags
 	if (ctx.timeout >= 0 && g_embloader.menu->default_entry)
 		ctx.timer = lv_timer_create(timer_cb, 1000, &ctx);
 	while (ctx.running) {
-		gBS->Stall(10000);
-		lv_tick_inc(10);
+		elapsed += efi_idle_stall(10000);
+		lv_tick_inc(elapsed / 1000);
+		elapsed %= 1000;
 		lv_timer_handler();
 	}
 done:
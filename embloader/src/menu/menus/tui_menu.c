@@ -585,7 +585,7 @@ static void draw_bottom(struct tui_context *ctx, bool update_layout) {
 	info_row = row_start;
 	if (ctx->timeout > 0) {
 		ctx->out->SetAttribute(ctx->out, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLACK));
-		printf_utf8_at(ctx, 2, info_row--, "Timeout: %d seconds", ctx->timeout / 1000);
+		printf_utf8_at(ctx, 2, info_row--, "Timeout: %d seconds", (ctx->timeout + 999) / 1000);
 	}
 	if (ctx->def_loader) {
 		ctx->out->SetAttribute(ctx->out, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLACK));
@@ -712,12 +712,16 @@ static EFI_STATUS read_once(struct tui_context *ctx) {
 	else if (
 		key.UnicodeChar == 'B' ||
 		key.UnicodeChar == 'b'
-	) gRT->ResetSystem(EfiResetCold, EFI_SUCCESS, 0, NULL);
-	else if (
+	) {
+		log_sync();
+		gRT->ResetSystem(EfiResetCold, EFI_SUCCESS, 0, NULL);
+	} else if (
 		key.UnicodeChar == 'O' ||
 		key.UnicodeChar == 'o'
-	) gRT->ResetSystem(EfiResetShutdown, EFI_SUCCESS, 0, NULL);
-	else if (
+	) {
+		log_sync();
+		gRT->ResetSystem(EfiResetShutdown, EFI_SUCCESS, 0, NULL);
+	} else if (
 		key.ScanCode == SCAN_HIBERNATE ||
 		key.ScanCode == SCAN_SUSPEND ||
 		key.UnicodeChar == CHAR_LINEFEED ||
@@ -827,6 +831,8 @@ static bool tui_filter_supports() {
 EFI_STATUS embloader_tui_menu_start(embloader_loader **selected, uint64_t *flags) {
 	struct tui_context ctx;
 	EFI_STATUS status;
+	UINTN elapsed = 0;
+	INTN step, last;
 	if (flags) *flags = 0;
 	if (!g_embloader.menu || !selected) return EFI_INVALID_PARAMETER;
 	if (!tui_filter_supports()) {
@@ -891,10 +897,13 @@ EFI_STATUS embloader_tui_menu_start(embloader_loader **selected, uint64_t *flags
 					if (flags) *flags = ctx.flags;
 					return EFI_SUCCESS;
 				}
-				gBS->Stall(100000);
+				elapsed += efi_idle_stall(100000);
+				step = (INTN) (elapsed / 1000);
+				elapsed %= 1000;
 				if (ctx.have_timeout && ctx.timeout > 0) {
-					ctx.timeout -= 100;
-					if (ctx.timeout % 1000 == 0) {
+					last = ctx.timeout;
+					ctx.timeout -= MIN(step, ctx.timeout);
+					if ((ctx.timeout + 999) / 1000 != (last + 999) / 1000) {
 						draw_bottom(&ctx, false);
 						ctx.out->SetCursorPosition(ctx.out, 0, ctx.row - 1);
 						break;
@@ -6,9 +6,12 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Guid/SmBios.h>
 #include <string.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <inttypes.h>
 #include "str-utils.h"
+#include "crc32.h"
 #include "smbios.h"
 #include "log.h"
 #include "embloader.h"
@@ -80,9 +83,12 @@ static bool check_smbios3(SMBIOS_TABLE_3_0_ENTRY_POINT*smbios){
 	return true;
 }
 
+static void smbios_build_index(embloader_smbios*ctx);
+
 void embloader_init_info_smbios(embloader_smbios*ctx){
 	SMBIOS_TABLE_ENTRY_POINT*smbios2=NULL;
 	SMBIOS_TABLE_3_0_ENTRY_POINT*smbios3=NULL;
+	embloader_smbios_free(ctx);
 	ctx->smbios2=NULL;
 	ctx->smbios3=NULL;
 	for(UINTN i=0;i<gST->NumberOfTableEntries;i++){
@@ -102,6 +108,7 @@ void embloader_init_info_smbios(embloader_smbios*ctx){
 		ctx->minor=ctx->smbios3->MinorVersion;
 	}
 	ctx->version=SMBIOS_VER(ctx->major,ctx->minor);
+	smbios_build_index(ctx);
 }
 
 static bool smbios_get_range(embloader_smbios*ctx,UINTN*start,UINTN*end){
@@ -136,12 +143,168 @@ static bool smbios_walk(embloader_smbios*ctx,SMBIOS_STRUCTURE_POINTER*p){
 	return true;
 }
 
+static bool smbios_grow(void **array, UINTN *size, UINTN need, UINTN item) {
+	UINTN nsize = *size > 0 ? *size : 64;
+	void *n;
+	if (need <= *size) return true;
+	while (nsize < need) nsize *= 2;
+	if (!(n = realloc(*array, nsize * item))) return false;
+	*array = n;
+	*size = nsize;
+	return true;
+}
+
+/*
+ * Walk the table once and record every structure with its string-set, so
+ * lookups by type, handle and string number never rescan the table.
+ */
+static void smbios_build_index(embloader_smbios *ctx) {
+	UINTN start = 0, end = 0, esize = 0, ssize = 0, scount = 0;
+	UINTN pos[256];
+	UINT8 *p, *s, *e;
+	if (!smbios_get_range(ctx, &start, &end)) return;
+	p = (UINT8*) start, e = (UINT8*) end;
+	while (p + sizeof(SMBIOS_STRUCTURE) <= e) {
+		SMBIOS_STRUCTURE *hdr = (SMBIOS_STRUCTURE*) p;
+		if (hdr->Length < sizeof(SMBIOS_STRUCTURE)) break;
+		if (p + hdr->Length + 2 > e) break;
+		if (!smbios_grow(
+			(void**) &ctx->entries, &esize,
+			ctx->count + 1, sizeof(embloader_smbios_entry)
+		)) goto fail;
+		embloader_smbios_entry *ent = &ctx->entries[ctx->count];
+		ent->ptr.Raw = p;
+		ent->strings = scount;
+		ent->string_count = 0;
+		s = p + hdr->Length;
+		if (*s == 0) s++;
+		else while (s < e && *s) {
+			if (!smbios_grow(
+				(void**) &ctx->strings, &ssize,
+				scount + 1, sizeof(const char*)
+			)) goto fail;
+			ctx->strings[scount++] = (const char*) s;
+			ent->string_count++;
+			while (s < e && *s) s++;
+			s++;
+		}
+		if (s >= e) break;
+		ent->size = ++s - p;
+		ctx->count++;
+		if (hdr->Type == 127) break;
+		p = s;
+	}
+	if (ctx->count == 0) goto fail;
+	if (!(ctx->by_type = malloc(ctx->count * sizeof(UINTN)))) goto fail;
+	if (!(ctx->by_handle = malloc(ctx->count * sizeof(UINTN)))) goto fail;
+	memset(ctx->type_start, 0, sizeof(ctx->type_start));
+	for (UINTN i = 0; i < ctx->count; i++)
+		ctx->type_start[ctx->entries[i].ptr.Hdr->Type + 1]++;
+	for (UINTN i = 0; i < 256; i++)
+		ctx->type_start[i + 1] += ctx->type_start[i];
+	memcpy(pos, ctx->type_start, sizeof(pos));
+	for (UINTN i = 0; i < ctx->count; i++)
+		ctx->by_type[pos[ctx->entries[i].ptr.Hdr->Type]++] = i;
+	/* handles are almost always ascending already, so insertion sort is linear */
+	for (UINTN i = 0; i < ctx->count; i++) {
+		UINTN j = i, idx = i;
+		SMBIOS_HANDLE h = ctx->entries[idx].ptr.Hdr->Handle;
+		for (; j > 0 && ctx->entries[ctx->by_handle[j - 1]].ptr.Hdr->Handle > h; j--)
+			ctx->by_handle[j] = ctx->by_handle[j - 1];
+		ctx->by_handle[j] = idx;
+	}
+	log_debug(
+		"indexed %" PRIu64 " smbios structures with %" PRIu64 " strings",
+		(uint64_t) ctx->count, (uint64_t) scount
+	);
+	return;
+fail:
+	log_warning("build smbios index failed, fallback to table walk");
+	embloader_smbios_free(ctx);
+}
+
+/**
+ * @brief Release the structure index built by embloader_init_info_smbios
+ *
+ * @param ctx SMBIOS context
+ */
+void embloader_smbios_free(embloader_smbios *ctx) {
+	if (!ctx) return;
+	if (ctx->entries) free(ctx->entries);
+	if (ctx->by_type) free(ctx->by_type);
+	if (ctx->by_handle) free(ctx->by_handle);
+	if (ctx->strings) free(ctx->strings);
+	ctx->entries = NULL, ctx->by_type = NULL;
+	ctx->by_handle = NULL, ctx->strings = NULL;
+	ctx->count = 0;
+}
+
+/**
+ * @brief Checksum the raw bytes of all SMBIOS structures
+ *
+ * @param ctx SMBIOS context
+ * @return CRC32 of the structure table, 0 if no table is present
+ */
+uint32_t embloader_smbios_checksum(embloader_smbios *ctx) {
+	UINTN start = 0, end = 0;
+	if (ctx && ctx->count > 0) {
+		embloader_smbios_entry *last = &ctx->entries[ctx->count - 1];
+		start = (UINTN) ctx->entries[0].ptr.Raw;
+		end = (UINTN) last->ptr.Raw + last->size;
+	} else if (!smbios_get_range(ctx, &start, &end)) return 0;
+	return s_crc32((void*) start, end - start);
+}
+
+static UINTN smbios_handle_lower_bound(embloader_smbios *ctx, SMBIOS_HANDLE handle) {
+	UINTN lo = 0, hi = ctx->count;
+	while (lo < hi) {
+		UINTN mid = lo + (hi - lo) / 2;
+		if (ctx->entries[ctx->by_handle[mid]].ptr.Hdr->Handle < handle) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+static embloader_smbios_entry *smbios_find_entry(embloader_smbios *ctx, SMBIOS_STRUCTURE_POINTER p) {
+	if (!ctx->by_handle) return NULL;
+	for (UINTN i = smbios_handle_lower_bound(ctx, p.Hdr->Handle); i < ctx->count; i++) {
+		embloader_smbios_entry *ent = &ctx->entries[ctx->by_handle[i]];
+		if (ent->ptr.Hdr->Handle != p.Hdr->Handle) break;
+		if (ent->ptr.Raw == p.Raw) return ent;
+	}
+	return NULL;
+}
+
+SMBIOS_STRUCTURE_POINTER embloader_get_smbios_by_type_index(
+	embloader_smbios *ctx,
+	uint8_t type,
+	UINTN index
+) {
+	SMBIOS_STRUCTURE_POINTER smbios = {}, nil = {};
+	if (!ctx) return nil;
+	if (ctx->by_type) {
+		UINTN i = ctx->type_start[type] + index;
+		if (i >= ctx->type_start[type + 1]) return nil;
+		return ctx->entries[ctx->by_type[i]].ptr;
+	}
+	while (smbios_walk(ctx, &smbios))
+		if (smbios.Hdr->Type == type && index-- == 0) return smbios;
+	return nil;
+}
+
 SMBIOS_STRUCTURE_POINTER embloader_get_smbios_by_type(
 	embloader_smbios*ctx,
 	uint8_t type,
 	SMBIOS_HANDLE handle
 ){
 	SMBIOS_STRUCTURE_POINTER smbios={},nil={};
+	if(ctx&&ctx->by_type){
+		for(UINTN i=ctx->type_start[type];i<ctx->type_start[type+1];i++){
+			smbios=ctx->entries[ctx->by_type[i]].ptr;
+			if(handle==0xFFFF||smbios.Hdr->Handle>handle)return smbios;
+		}
+		return nil;
+	}
 	while(smbios_walk(ctx,&smbios)){
 		if(smbios.Hdr->Type!=type)continue;
 		if(handle==0xFFFF)return smbios;
@@ -155,6 +318,12 @@ SMBIOS_STRUCTURE_POINTER embloader_get_smbios_by_handle(
 	SMBIOS_HANDLE handle
 ){
 	SMBIOS_STRUCTURE_POINTER smbios={},nil={};
+	if(ctx&&ctx->by_handle){
+		UINTN i=smbios_handle_lower_bound(ctx,handle);
+		if(i>=ctx->count)return nil;
+		smbios=ctx->entries[ctx->by_handle[i]].ptr;
+		return smbios.Hdr->Handle==handle?smbios:nil;
+	}
 	while(smbios_walk(ctx,&smbios))
 		if(smbios.Hdr->Handle==handle)return smbios;
 	return nil;
@@ -166,8 +335,11 @@ const char*embloader_get_smbios_string(
 	SMBIOS_TABLE_STRING id
 ){
 	UINTN start=0,end=0;
+	embloader_smbios_entry*ent;
 	if(id==0||!p.Raw||!smbios_get_range(ctx,&start,&end))return NULL;
 	if(p.Hdr->Type==127)return NULL;
+	if(ctx->by_handle&&(ent=smbios_find_entry(ctx,p)))
+		return id<=ent->string_count?ctx->strings[ent->strings+id-1]:NULL;
 	if((UINTN)p.Raw+p.Hdr->Length>end)return NULL;
 	if(p.Hdr->Length<sizeof(SMBIOS_STRUCTURE))return NULL;
 	const char*str=(void*)p.Raw+p.Hdr->Length;
@@ -182,8 +354,8 @@ const char*embloader_get_smbios_string(
 void embloader_smbios_set_config_string(
 	embloader_smbios *ctx,
 	SMBIOS_STRUCTURE_POINTER ptr,
-	confignode *node,
-	const char *path,
+	confignode_builder *b,
+	const char *key,
 	SMBIOS_TABLE_STRING index
 ) {
 	char buff[256];
@@ -191,20 +363,20 @@ void embloader_smbios_set_config_string(
 	embloader_load_smbios_string(
 		ctx, ptr, index, buff, sizeof(buff)
 	);
-	confignode_path_set_string(node, path, buff);
+	confignode_builder_set_string(b, key, buff);
 }
 
 void embloader_smbios_set_config_guid(
 	embloader_smbios *ctx,
 	SMBIOS_STRUCTURE_POINTER ptr,
-	confignode *node,
-	const char *path,
+	confignode_builder *b,
+	const char *key,
 	GUID *guid
 ) {
 	char buff[256];
 	memset(buff, 0, sizeof(buff));
 	AsciiSPrint(buff, sizeof(buff), "%g", guid);
-	confignode_path_set_string(node, path, buff);
+	confignode_builder_set_string(b, key, buff);
 }
 
 bool embloader_load_smbios_string(
@@ -229,31 +401,31 @@ bool embloader_load_smbios_string(
 
 void embloader_smbios_load_table(
 	embloader_smbios *ctx,
+	confignode_builder *b,
 	uint8_t type,
 	const char *name,
-	void (*load)(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr)
+	void (*load)(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr)
 ) {
-	confignode *m;
-	confignode *s = g_embloader.sysinfo;
+	confignode *s = confignode_builder_current(b);
 	SMBIOS_STRUCTURE_POINTER ptr;
-	SMBIOS_HANDLE handle = 0xFFFF;
 	int i = 0;
-	while (true) {
-		ptr = embloader_get_smbios_by_type(ctx, type, handle);
+	if (!s) return;
+	for (UINTN n = 0; ; n++) {
+		ptr = embloader_get_smbios_by_type_index(ctx, type, n);
 		if (!ptr.Raw) return;
-		if (!(m = confignode_new_map())) return;
 		char buff[64];
 		while (true) {
-			snprintf(buff, sizeof(buff), "smbios.%s%d", name, i++);
-			if (!confignode_path_lookup(s, buff, false)) break;
+			snprintf(buff, sizeof(buff), "%s%d", name, i++);
+			if (!confignode_map_get(s, buff)) break;
+		}
+		if (confignode_builder_push_map(b, buff)) {
+			confignode_builder_push_map(b, "header");
+			confignode_builder_set_int(b, "type", ptr.Hdr->Type);
+			confignode_builder_set_int(b, "length", ptr.Hdr->Length);
+			confignode_builder_set_int(b, "handle", ptr.Hdr->Handle);
+			confignode_builder_pop(b);
+			if (load) load(ctx, b, ptr);
 		}
-		confignode_path_map_set(s, buff, m);
-		confignode *hm = confignode_new_map();
-		confignode_path_map_set(m, "header", hm);
-		confignode_path_set_int(hm, "type", ptr.Hdr->Type);
-		confignode_path_set_int(hm, "length", ptr.Hdr->Length);
-		confignode_path_set_int(hm, "handle", ptr.Hdr->Handle);
-		if (load) load(ctx, m, ptr);
-		handle = ptr.Hdr->Handle;
+		confignode_builder_pop(b);
 	}
 }
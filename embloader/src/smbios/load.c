@@ -1,24 +1,73 @@
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
+#include <inttypes.h>
 #include "smbios.h"
 #include "debugs.h"
 #include "embloader.h"
+#include "ticks.h"
+#include "log.h"
 
-bool embloader_load_smbios() {
-	embloader_smbios smbios;
-	memset(&smbios, 0, sizeof(smbios));
-	embloader_init_info_smbios(&smbios);
-	if (!smbios.smbios2 && !smbios.smbios3) return false;
-	confignode_path_set_int(g_embloader.sysinfo, "smbios.major", smbios.major);
-	confignode_path_set_int(g_embloader.sysinfo, "smbios.minor", smbios.minor);
-	confignode_path_set_string_fmt(g_embloader.sysinfo, "smbios.version", "%u.%u", smbios.major, smbios.minor);
+static embloader_smbios smbios;
+static uint64_t smbios_decoded = 0; /* bit per smbios_table_loads entry */
+
+static bool smbios_table_match(const char *name, const char *key) {
+	size_t len = strlen(name);
+	if (strncmp(name, key, len) != 0 || !key[len]) return false;
+	for (key += len; *key; key++)
+		if (!isdigit(*key)) return false;
+	return true;
+}
+
+/*
+ * Decode the tables behind smbios.<name><N> when such a key is first looked
+ * up, or all of them when the smbios map is iterated or printed.
+ */
+static bool smbios_resolve(confignode *node, const char *key, void *data) {
+	embloader_smbios *ctx = data;
+	confignode_builder b;
+	bool pending = false;
 	for (size_t i = 0; smbios_table_loads[i].load != NULL; i++) {
+		uint64_t bit = 1ULL << i;
+		if (smbios_decoded & bit) continue;
+		if (key && !smbios_table_match(smbios_table_loads[i].name, key)) {
+			pending = true;
+			continue;
+		}
+		smbios_decoded |= bit;
+		confignode_builder_init(&b, node);
 		embloader_smbios_load_table(
-			&smbios,
+			ctx, &b,
 			smbios_table_loads[i].type,
 			smbios_table_loads[i].name,
 			smbios_table_loads[i].load
 		);
 	}
+	if (pending) return true;
+	log_debug("all smbios tables decoded");
+	embloader_smbios_free(ctx);
+	return false;
+}
+
+bool embloader_load_smbios() {
+	confignode_builder b;
+	confignode *node;
+	uint64_t start = ticks_usec();
+	embloader_init_info_smbios(&smbios);
+	if (!smbios.smbios2 && !smbios.smbios3) return false;
+	g_embloader.smbios_crc = embloader_smbios_checksum(&smbios);
+	confignode_builder_init(&b, g_embloader.sysinfo);
+	if (!(node = confignode_builder_push_map(&b, "smbios"))) {
+		embloader_smbios_free(&smbios);
+		return false;
+	}
+	confignode_builder_set_int(&b, "major", smbios.major);
+	confignode_builder_set_int(&b, "minor", smbios.minor);
+	confignode_builder_set_string_fmt(&b, "version", "%u.%u", smbios.major, smbios.minor);
+	smbios_decoded = 0;
+	if (confignode_path_get_bool(g_embloader.config, "smbios.lazy", true, NULL))
+		confignode_map_set_resolver(node, smbios_resolve, &smbios);
+	else smbios_resolve(node, NULL, &smbios);
+	log_debug("loaded smbios in %" PRIu64 "us", ticks_usec() - start);
 	return true;
 }
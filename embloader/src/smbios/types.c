@@ -50,3 +50,8 @@ struct smbios_table_load smbios_table_loads[] = {
 	{46, "prop_id",            smbios_load_type46},
 	{0, NULL, NULL},
 };
+
+STATIC_ASSERT(
+	ARRAY_SIZE(smbios_table_loads) - 1 <= SMBIOS_TABLE_LOADS_MAX,
+	"too many smbios tables for the decoded bit mask"
+);
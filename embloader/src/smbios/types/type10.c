@@ -1,16 +1,16 @@
 #include "../smbios.h"
 
-void smbios_load_type10(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type10(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE10 *t = ptr.Type10;
 	int device_count = (t->Hdr.Length - sizeof(SMBIOS_STRUCTURE)) / sizeof(DEVICE_STRUCT);
-	confignode_path_set_int(m, "device_count", device_count);
-	confignode *device_array = confignode_new_array();
-	confignode_path_map_set(m, "devices", device_array);
+	confignode_builder_set_int(b, "device_count", device_count);
+	confignode_builder_push_array(b, "devices");
 	for (int i = 0; i < device_count; ++i) {
-		confignode *device = confignode_new_map();
-		confignode_array_append(device_array, device);
-		confignode_path_set_int(device, "type", t->Device[i].DeviceType & 0x7F);
-		confignode_path_set_bool(device, "enabled", (t->Device[i].DeviceType & 0x80) != 0);
-		embloader_smbios_set_config_string(ctx, ptr, device, "description", t->Device[i].DescriptionString);
+		confignode_builder_push_map(b, NULL);
+		confignode_builder_set_int(b, "type", t->Device[i].DeviceType & 0x7F);
+		confignode_builder_set_bool(b, "enabled", (t->Device[i].DeviceType & 0x80) != 0);
+		embloader_smbios_set_config_string(ctx, ptr, b, "description", t->Device[i].DescriptionString);
+		confignode_builder_pop(b);
 	}
+	confignode_builder_pop(b);
 }
@@ -1,23 +1,23 @@
 #include "../smbios.h"
 
-void smbios_load_type15(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type15(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE15 *t = ptr.Type15;
-	confignode_path_set_int(m, "log_area_length", t->LogAreaLength);
-	confignode_path_set_int(m, "log_header_start_offset", t->LogHeaderStartOffset);
-	confignode_path_set_int(m, "log_data_start_offset", t->LogDataStartOffset);
-	confignode_path_set_int(m, "access_method", t->AccessMethod);
-	confignode_path_set_int(m, "log_status", t->LogStatus);
-	confignode_path_set_int(m, "log_change_token", t->LogChangeToken);
-	confignode_path_set_int(m, "access_method_address", t->AccessMethodAddress);
-	confignode_path_set_int(m, "log_header_format", t->LogHeaderFormat);
-	confignode_path_set_int(m, "number_of_supported_log_type_descriptors", t->NumberOfSupportedLogTypeDescriptors);
-	confignode_path_set_int(m, "length_of_log_type_descriptor", t->LengthOfLogTypeDescriptor);
-	confignode *descriptors_array = confignode_new_array();
-	confignode_path_map_set(m, "event_log_type_descriptors", descriptors_array);
+	confignode_builder_set_int(b, "log_area_length", t->LogAreaLength);
+	confignode_builder_set_int(b, "log_header_start_offset", t->LogHeaderStartOffset);
+	confignode_builder_set_int(b, "log_data_start_offset", t->LogDataStartOffset);
+	confignode_builder_set_int(b, "access_method", t->AccessMethod);
+	confignode_builder_set_int(b, "log_status", t->LogStatus);
+	confignode_builder_set_int(b, "log_change_token", t->LogChangeToken);
+	confignode_builder_set_int(b, "access_method_address", t->AccessMethodAddress);
+	confignode_builder_set_int(b, "log_header_format", t->LogHeaderFormat);
+	confignode_builder_set_int(b, "number_of_supported_log_type_descriptors", t->NumberOfSupportedLogTypeDescriptors);
+	confignode_builder_set_int(b, "length_of_log_type_descriptor", t->LengthOfLogTypeDescriptor);
+	confignode_builder_push_array(b, "event_log_type_descriptors");
 	for (int i = 0; i < t->NumberOfSupportedLogTypeDescriptors; ++i) {
-		confignode *descriptor = confignode_new_map();
-		confignode_array_append(descriptors_array, descriptor);
-		confignode_path_set_int(descriptor, "log_type", t->EventLogTypeDescriptors[i].LogType);
-		confignode_path_set_int(descriptor, "data_format_type", t->EventLogTypeDescriptors[i].DataFormatType);
+		confignode_builder_push_map(b, NULL);
+		confignode_builder_set_int(b, "log_type", t->EventLogTypeDescriptors[i].LogType);
+		confignode_builder_set_int(b, "data_format_type", t->EventLogTypeDescriptors[i].DataFormatType);
+		confignode_builder_pop(b);
 	}
+	confignode_builder_pop(b);
 }
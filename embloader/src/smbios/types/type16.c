@@ -13,22 +13,22 @@ static const char *memory_error_correction[] = {
 	"null", "other", "unknown", "none", "parity", "single_bit_ecc", "multi_bit_ecc", "crc"
 };
 
-void smbios_load_type16(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type16(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE16 *t = ptr.Type16;
-	confignode_path_set_string(m, "location",
+	confignode_builder_set_string(b, "location",
 		t->Location < sizeof(memory_array_location)/sizeof(memory_array_location[0]) ?
 		memory_array_location[t->Location] : "unknown");
-	confignode_path_set_string(m, "use",
+	confignode_builder_set_string(b, "use",
 		t->Use < sizeof(memory_array_use)/sizeof(memory_array_use[0]) ?
 		memory_array_use[t->Use] : "unknown");
-	confignode_path_set_string(m, "memory_error_correction",
+	confignode_builder_set_string(b, "memory_error_correction",
 		t->MemoryErrorCorrection < sizeof(memory_error_correction)/sizeof(memory_error_correction[0]) ?
 		memory_error_correction[t->MemoryErrorCorrection] : "unknown");
 	if (ctx->version >= SMBIOS_VER(2,7) && t->MaximumCapacity == 0x80000000) {
-		confignode_path_set_int(m, "maximum_capacity", t->ExtendedMaximumCapacity);
+		confignode_builder_set_int(b, "maximum_capacity", t->ExtendedMaximumCapacity);
 	} else {
-		confignode_path_set_int(m, "maximum_capacity", t->MaximumCapacity);
+		confignode_builder_set_int(b, "maximum_capacity", t->MaximumCapacity);
 	}
-	confignode_path_set_int(m, "memory_error_information_handle", t->MemoryErrorInformationHandle);
-	confignode_path_set_int(m, "number_of_memory_devices", t->NumberOfMemoryDevices);
+	confignode_builder_set_int(b, "memory_error_information_handle", t->MemoryErrorInformationHandle);
+	confignode_builder_set_int(b, "number_of_memory_devices", t->NumberOfMemoryDevices);
 }
@@ -17,85 +17,87 @@ static const char *memory_technology[] = {
 	"null", "other", "unknown", "dram", "nvdimm_n", "nvdimm_f", "nvdimm_p", "intel_optane_persistent_memory"
 };
 
-void smbios_load_type17(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type17(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE17 *t = ptr.Type17;
-	confignode_path_set_int(m, "memory_array_handle", t->MemoryArrayHandle);
-	confignode_path_set_int(m, "memory_error_information_handle", t->MemoryErrorInformationHandle);
-	confignode_path_set_int(m, "total_width", t->TotalWidth);
-	confignode_path_set_int(m, "data_width", t->DataWidth);
+	confignode_builder_set_int(b, "memory_array_handle", t->MemoryArrayHandle);
+	confignode_builder_set_int(b, "memory_error_information_handle", t->MemoryErrorInformationHandle);
+	confignode_builder_set_int(b, "total_width", t->TotalWidth);
+	confignode_builder_set_int(b, "data_width", t->DataWidth);
 	if (ctx->version >= SMBIOS_VER(2,7) && t->Size == 0x7FFF) {
-		confignode_path_set_int(m, "size", t->ExtendedSize);
+		confignode_builder_set_int(b, "size", t->ExtendedSize);
 	} else {
-		confignode_path_set_int(m, "size", t->Size);
+		confignode_builder_set_int(b, "size", t->Size);
 	}
-	confignode_path_set_string(m, "form_factor",
+	confignode_builder_set_string(b, "form_factor",
 		t->FormFactor < sizeof(memory_form_factor)/sizeof(memory_form_factor[0]) ?
 		memory_form_factor[t->FormFactor] : "unknown");
-	confignode_path_set_int(m, "device_set", t->DeviceSet);
-	embloader_smbios_set_config_string(ctx, ptr, m, "device_locator", t->DeviceLocator);
-	embloader_smbios_set_config_string(ctx, ptr, m, "bank_locator", t->BankLocator);
-	confignode_path_set_string(m, "memory_type",
+	confignode_builder_set_int(b, "device_set", t->DeviceSet);
+	embloader_smbios_set_config_string(ctx, ptr, b, "device_locator", t->DeviceLocator);
+	embloader_smbios_set_config_string(ctx, ptr, b, "bank_locator", t->BankLocator);
+	confignode_builder_set_string(b, "memory_type",
 		t->MemoryType < sizeof(memory_device_type)/sizeof(memory_device_type[0]) ?
 		memory_device_type[t->MemoryType] : "unknown");
-	confignode_path_set_bool(m, "type_detail.other", t->TypeDetail.Other);
-	confignode_path_set_bool(m, "type_detail.unknown", t->TypeDetail.Unknown);
-	confignode_path_set_bool(m, "type_detail.fast_paged", t->TypeDetail.FastPaged);
-	confignode_path_set_bool(m, "type_detail.static_column", t->TypeDetail.StaticColumn);
-	confignode_path_set_bool(m, "type_detail.pseudo_static", t->TypeDetail.PseudoStatic);
-	confignode_path_set_bool(m, "type_detail.rambus", t->TypeDetail.Rambus);
-	confignode_path_set_bool(m, "type_detail.synchronous", t->TypeDetail.Synchronous);
-	confignode_path_set_bool(m, "type_detail.cmos", t->TypeDetail.Cmos);
-	confignode_path_set_bool(m, "type_detail.edo", t->TypeDetail.Edo);
-	confignode_path_set_bool(m, "type_detail.window_dram", t->TypeDetail.WindowDram);
-	confignode_path_set_bool(m, "type_detail.cache_dram", t->TypeDetail.CacheDram);
-	confignode_path_set_bool(m, "type_detail.nonvolatile", t->TypeDetail.Nonvolatile);
-	confignode_path_set_bool(m, "type_detail.registered", t->TypeDetail.Registered);
-	confignode_path_set_bool(m, "type_detail.unbuffered", t->TypeDetail.Unbuffered);
-	confignode_path_set_bool(m, "type_detail.lr_dimm", t->TypeDetail.LrDimm);
-	confignode_path_set_int(m, "speed", t->Speed);
-	embloader_smbios_set_config_string(ctx, ptr, m, "manufacturer", t->Manufacturer);
-	embloader_smbios_set_config_string(ctx, ptr, m, "serial_number", t->SerialNumber);
-	embloader_smbios_set_config_string(ctx, ptr, m, "asset_tag", t->AssetTag);
-	embloader_smbios_set_config_string(ctx, ptr, m, "part_number", t->PartNumber);
+	confignode_builder_push_map(b, "type_detail");
+	confignode_builder_set_bool(b, "other", t->TypeDetail.Other);
+	confignode_builder_set_bool(b, "unknown", t->TypeDetail.Unknown);
+	confignode_builder_set_bool(b, "fast_paged", t->TypeDetail.FastPaged);
+	confignode_builder_set_bool(b, "static_column", t->TypeDetail.StaticColumn);
+	confignode_builder_set_bool(b, "pseudo_static", t->TypeDetail.PseudoStatic);
+	confignode_builder_set_bool(b, "rambus", t->TypeDetail.Rambus);
+	confignode_builder_set_bool(b, "synchronous", t->TypeDetail.Synchronous);
+	confignode_builder_set_bool(b, "cmos", t->TypeDetail.Cmos);
+	confignode_builder_set_bool(b, "edo", t->TypeDetail.Edo);
+	confignode_builder_set_bool(b, "window_dram", t->TypeDetail.WindowDram);
+	confignode_builder_set_bool(b, "cache_dram", t->TypeDetail.CacheDram);
+	confignode_builder_set_bool(b, "nonvolatile", t->TypeDetail.Nonvolatile);
+	confignode_builder_set_bool(b, "registered", t->TypeDetail.Registered);
+	confignode_builder_set_bool(b, "unbuffered", t->TypeDetail.Unbuffered);
+	confignode_builder_set_bool(b, "lr_dimm", t->TypeDetail.LrDimm);
+	confignode_builder_pop(b);
+	confignode_builder_set_int(b, "speed", t->Speed);
+	embloader_smbios_set_config_string(ctx, ptr, b, "manufacturer", t->Manufacturer);
+	embloader_smbios_set_config_string(ctx, ptr, b, "serial_number", t->SerialNumber);
+	embloader_smbios_set_config_string(ctx, ptr, b, "asset_tag", t->AssetTag);
+	embloader_smbios_set_config_string(ctx, ptr, b, "part_number", t->PartNumber);
 	if (ctx->version >= SMBIOS_VER(2,6)) {
-		confignode_path_set_int(m, "attributes", t->Attributes);
+		confignode_builder_set_int(b, "attributes", t->Attributes);
 	}
 	if (ctx->version >= SMBIOS_VER(2,7)) {
 		// ExtendedSize is handled above in the Size field logic
-		confignode_path_set_int(m, "configured_memory_clock_speed", t->ConfiguredMemoryClockSpeed);
+		confignode_builder_set_int(b, "configured_memory_clock_speed", t->ConfiguredMemoryClockSpeed);
 	}
 	if (ctx->version >= SMBIOS_VER(2,8)) {
-		confignode_path_set_int(m, "minimum_voltage", t->MinimumVoltage);
-		confignode_path_set_int(m, "maximum_voltage", t->MaximumVoltage);
-		confignode_path_set_int(m, "configured_voltage", t->ConfiguredVoltage);
+		confignode_builder_set_int(b, "minimum_voltage", t->MinimumVoltage);
+		confignode_builder_set_int(b, "maximum_voltage", t->MaximumVoltage);
+		confignode_builder_set_int(b, "configured_voltage", t->ConfiguredVoltage);
 	}
 	if (ctx->version >= SMBIOS_VER(3,2)) {
-		confignode_path_set_string(m, "memory_technology",
+		confignode_builder_set_string(b, "memory_technology",
 			t->MemoryTechnology < sizeof(memory_technology)/sizeof(memory_technology[0]) ?
 			memory_technology[t->MemoryTechnology] : "unknown");
-		confignode_path_set_bool(m, "operating_mode_other", t->MemoryOperatingModeCapability.Bits.Other);
-		confignode_path_set_bool(m, "operating_mode_unknown", t->MemoryOperatingModeCapability.Bits.Unknown);
-		confignode_path_set_bool(m, "operating_mode_volatile_memory", t->MemoryOperatingModeCapability.Bits.VolatileMemory);
-		confignode_path_set_bool(m, "operating_mode_byte_accessible_persistent_memory", t->MemoryOperatingModeCapability.Bits.ByteAccessiblePersistentMemory);
-		confignode_path_set_bool(m, "operating_mode_block_accessible_persistent_memory", t->MemoryOperatingModeCapability.Bits.BlockAccessiblePersistentMemory);
-		embloader_smbios_set_config_string(ctx, ptr, m, "firmware_version", t->FirmwareVersion);
-		confignode_path_set_int(m, "module_manufacturer_id", t->ModuleManufacturerID);
-		confignode_path_set_int(m, "module_product_id", t->ModuleProductID);
-		confignode_path_set_int(m, "memory_subsystem_controller_manufacturer_id", t->MemorySubsystemControllerManufacturerID);
-		confignode_path_set_int(m, "memory_subsystem_controller_product_id", t->MemorySubsystemControllerProductID);
-		confignode_path_set_int(m, "non_volatile_size", t->NonVolatileSize);
-		confignode_path_set_int(m, "volatile_size", t->VolatileSize);
-		confignode_path_set_int(m, "cache_size", t->CacheSize);
-		confignode_path_set_int(m, "logical_size", t->LogicalSize);
+		confignode_builder_set_bool(b, "operating_mode_other", t->MemoryOperatingModeCapability.Bits.Other);
+		confignode_builder_set_bool(b, "operating_mode_unknown", t->MemoryOperatingModeCapability.Bits.Unknown);
+		confignode_builder_set_bool(b, "operating_mode_volatile_memory", t->MemoryOperatingModeCapability.Bits.VolatileMemory);
+		confignode_builder_set_bool(b, "operating_mode_byte_accessible_persistent_memory", t->MemoryOperatingModeCapability.Bits.ByteAccessiblePersistentMemory);
+		confignode_builder_set_bool(b, "operating_mode_block_accessible_persistent_memory", t->MemoryOperatingModeCapability.Bits.BlockAccessiblePersistentMemory);
+		embloader_smbios_set_config_string(ctx, ptr, b, "firmware_version", t->FirmwareVersion);
+		confignode_builder_set_int(b, "module_manufacturer_id", t->ModuleManufacturerID);
+		confignode_builder_set_int(b, "module_product_id", t->ModuleProductID);
+		confignode_builder_set_int(b, "memory_subsystem_controller_manufacturer_id", t->MemorySubsystemControllerManufacturerID);
+		confignode_builder_set_int(b, "memory_subsystem_controller_product_id", t->MemorySubsystemControllerProductID);
+		confignode_builder_set_int(b, "non_volatile_size", t->NonVolatileSize);
+		confignode_builder_set_int(b, "volatile_size", t->VolatileSize);
+		confignode_builder_set_int(b, "cache_size", t->CacheSize);
+		confignode_builder_set_int(b, "logical_size", t->LogicalSize);
 	}
 	if (ctx->version >= SMBIOS_VER(3,3)) {
-		confignode_path_set_int(m, "extended_speed", t->ExtendedSpeed);
-		confignode_path_set_int(m, "extended_configured_memory_speed", t->ExtendedConfiguredMemorySpeed);
+		confignode_builder_set_int(b, "extended_speed", t->ExtendedSpeed);
+		confignode_builder_set_int(b, "extended_configured_memory_speed", t->ExtendedConfiguredMemorySpeed);
 	}
 	if (ctx->version >= SMBIOS_VER(3,7)) {
-		confignode_path_set_int(m, "pmic0_manufacturer_id", t->Pmic0ManufacturerID);
-		confignode_path_set_int(m, "pmic0_revision_number", t->Pmic0RevisionNumber);
-		confignode_path_set_int(m, "rcd_manufacturer_id", t->RcdManufacturerID);
-		confignode_path_set_int(m, "rcd_revision_number", t->RcdRevisionNumber);
+		confignode_builder_set_int(b, "pmic0_manufacturer_id", t->Pmic0ManufacturerID);
+		confignode_builder_set_int(b, "pmic0_revision_number", t->Pmic0RevisionNumber);
+		confignode_builder_set_int(b, "rcd_manufacturer_id", t->RcdManufacturerID);
+		confignode_builder_set_int(b, "rcd_revision_number", t->RcdRevisionNumber);
 	}
 }
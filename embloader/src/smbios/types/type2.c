@@ -17,20 +17,20 @@ static const char *baseboard_type[] = {
 	"interconnect_board",
 };
 
-void smbios_load_type2(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type2(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE2 *t = ptr.Type2;
-	embloader_smbios_set_config_string(ctx, ptr, m, "manufacturer", t->Manufacturer);
-	embloader_smbios_set_config_string(ctx, ptr, m, "product", t->ProductName);
-	embloader_smbios_set_config_string(ctx, ptr, m, "version", t->Version);
-	embloader_smbios_set_config_string(ctx, ptr, m, "serial_number", t->SerialNumber);
-	embloader_smbios_set_config_string(ctx, ptr, m, "asset_tag", t->AssetTag);
+	embloader_smbios_set_config_string(ctx, ptr, b, "manufacturer", t->Manufacturer);
+	embloader_smbios_set_config_string(ctx, ptr, b, "product", t->ProductName);
+	embloader_smbios_set_config_string(ctx, ptr, b, "version", t->Version);
+	embloader_smbios_set_config_string(ctx, ptr, b, "serial_number", t->SerialNumber);
+	embloader_smbios_set_config_string(ctx, ptr, b, "asset_tag", t->AssetTag);
 	BASE_BOARD_FEATURE_FLAGS *f = &t->FeatureFlag;
-	confignode_path_set_bool(m, "motherboard", f->Motherboard);
-	confignode_path_set_bool(m, "requires_daughter_card", f->RequiresDaughterCard);
-	confignode_path_set_bool(m, "removable", f->Removable);
-	confignode_path_set_bool(m, "replaceable", f->Replaceable);
-	confignode_path_set_bool(m, "hot_swappable", f->HotSwappable);
-	embloader_smbios_set_config_string(ctx, ptr, m, "location_in_chassis", t->LocationInChassis);
-	confignode_path_set_int(m, "chassis_handle", t->ChassisHandle);
-	confignode_path_set_string(m, "board_type", t->BoardType < 0xd ? baseboard_type[t->BoardType] : "unknown");
+	confignode_builder_set_bool(b, "motherboard", f->Motherboard);
+	confignode_builder_set_bool(b, "requires_daughter_card", f->RequiresDaughterCard);
+	confignode_builder_set_bool(b, "removable", f->Removable);
+	confignode_builder_set_bool(b, "replaceable", f->Replaceable);
+	confignode_builder_set_bool(b, "hot_swappable", f->HotSwappable);
+	embloader_smbios_set_config_string(ctx, ptr, b, "location_in_chassis", t->LocationInChassis);
+	confignode_builder_set_int(b, "chassis_handle", t->ChassisHandle);
+	confignode_builder_set_string(b, "board_type", t->BoardType < 0xd ? baseboard_type[t->BoardType] : "unknown");
 }
@@ -1,8 +1,8 @@
 #include "../smbios.h"
 
-void smbios_load_type21(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type21(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE21 *t = ptr.Type21;
-	confignode_path_set_int(m, "type", t->Type);
-	confignode_path_set_int(m, "interface", t->Interface);
-	confignode_path_set_int(m, "number_of_buttons", t->NumberOfButtons);
+	confignode_builder_set_int(b, "type", t->Type);
+	confignode_builder_set_int(b, "interface", t->Interface);
+	confignode_builder_set_int(b, "number_of_buttons", t->NumberOfButtons);
 }
@@ -1,10 +1,10 @@
 #include "../smbios.h"
 
-void smbios_load_type23(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type23(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE23 *t = ptr.Type23;
-	confignode_path_set_int(m, "capabilities", t->Capabilities);
-	confignode_path_set_int(m, "reset_count", t->ResetCount);
-	confignode_path_set_int(m, "reset_limit", t->ResetLimit);
-	confignode_path_set_int(m, "timer_interval", t->TimerInterval);
-	confignode_path_set_int(m, "timeout", t->Timeout);
+	confignode_builder_set_int(b, "capabilities", t->Capabilities);
+	confignode_builder_set_int(b, "reset_count", t->ResetCount);
+	confignode_builder_set_int(b, "reset_limit", t->ResetLimit);
+	confignode_builder_set_int(b, "timer_interval", t->TimerInterval);
+	confignode_builder_set_int(b, "timeout", t->Timeout);
 }
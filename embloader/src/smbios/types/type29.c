@@ -1,15 +1,15 @@
 #include "../smbios.h"
 
-void smbios_load_type29(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type29(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE29 *t = ptr.Type29;
-	embloader_smbios_set_config_string(ctx, ptr, m, "description", t->Description);
-	confignode_path_set_int(m, "probe_site", t->LocationAndStatus.ElectricalCurrentProbeSite);
-	confignode_path_set_int(m, "probe_status", t->LocationAndStatus.ElectricalCurrentProbeStatus);
-	confignode_path_set_int(m, "maximum_value", t->MaximumValue);
-	confignode_path_set_int(m, "minimum_value", t->MinimumValue);
-	confignode_path_set_int(m, "resolution", t->Resolution);
-	confignode_path_set_int(m, "tolerance", t->Tolerance);
-	confignode_path_set_int(m, "accuracy", t->Accuracy);
-	confignode_path_set_int(m, "oem_defined", t->OEMDefined);
-	confignode_path_set_int(m, "nominal_value", t->NominalValue);
+	embloader_smbios_set_config_string(ctx, ptr, b, "description", t->Description);
+	confignode_builder_set_int(b, "probe_site", t->LocationAndStatus.ElectricalCurrentProbeSite);
+	confignode_builder_set_int(b, "probe_status", t->LocationAndStatus.ElectricalCurrentProbeStatus);
+	confignode_builder_set_int(b, "maximum_value", t->MaximumValue);
+	confignode_builder_set_int(b, "minimum_value", t->MinimumValue);
+	confignode_builder_set_int(b, "resolution", t->Resolution);
+	confignode_builder_set_int(b, "tolerance", t->Tolerance);
+	confignode_builder_set_int(b, "accuracy", t->Accuracy);
+	confignode_builder_set_int(b, "oem_defined", t->OEMDefined);
+	confignode_builder_set_int(b, "nominal_value", t->NominalValue);
 }
@@ -92,16 +92,16 @@ static const char *chassis_security_state[] = {
 	"external_interface_locked_enabled",
 };
 
-void smbios_load_type3(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type3(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE3 *t = ptr.Type3;
-	embloader_smbios_set_config_string(ctx, ptr, m, "manufacturer", t->Manufacturer);
-	confignode_path_set_string(m, "type", t->Type < sizeof(chassis_type)/sizeof(chassis_type[0]) ? chassis_type[t->Type] : "unknown");
-	embloader_smbios_set_config_string(ctx, ptr, m, "version", t->Version);
-	embloader_smbios_set_config_string(ctx, ptr, m, "serial_number", t->SerialNumber);
-	embloader_smbios_set_config_string(ctx, ptr, m, "asset_tag", t->AssetTag);
-	confignode_path_set_string(m, "bootup_state", t->BootupState < sizeof(chassis_state)/sizeof(chassis_state[0]) ? chassis_state[t->BootupState-1] : "unknown");
-	confignode_path_set_string(m, "power_supply_state", t->PowerSupplyState < sizeof(chassis_state)/sizeof(chassis_state[0]) ? chassis_state[t->PowerSupplyState-1] : "unknown");
-	confignode_path_set_string(m, "thermal_state", t->ThermalState < sizeof(chassis_state)/sizeof(chassis_state[0]) ? chassis_state[t->ThermalState-1] : "unknown");
-	confignode_path_set_string(m, "security_status", t->SecurityStatus >= 1 && t->SecurityStatus <= 5 ? chassis_security_state[t->SecurityStatus-1] : "unknown");
-	confignode_path_set_int(m, "height", t->Height);
+	embloader_smbios_set_config_string(ctx, ptr, b, "manufacturer", t->Manufacturer);
+	confignode_builder_set_string(b, "type", t->Type < sizeof(chassis_type)/sizeof(chassis_type[0]) ? chassis_type[t->Type] : "unknown");
+	embloader_smbios_set_config_string(ctx, ptr, b, "version", t->Version);
+	embloader_smbios_set_config_string(ctx, ptr, b, "serial_number", t->SerialNumber);
+	embloader_smbios_set_config_string(ctx, ptr, b, "asset_tag", t->AssetTag);
+	confignode_builder_set_string(b, "bootup_state", t->BootupState < sizeof(chassis_state)/sizeof(chassis_state[0]) ? chassis_state[t->BootupState-1] : "unknown");
+	confignode_builder_set_string(b, "power_supply_state", t->PowerSupplyState < sizeof(chassis_state)/sizeof(chassis_state[0]) ? chassis_state[t->PowerSupplyState-1] : "unknown");
+	confignode_builder_set_string(b, "thermal_state", t->ThermalState < sizeof(chassis_state)/sizeof(chassis_state[0]) ? chassis_state[t->ThermalState-1] : "unknown");
+	confignode_builder_set_string(b, "security_status", t->SecurityStatus >= 1 && t->SecurityStatus <= 5 ? chassis_security_state[t->SecurityStatus-1] : "unknown");
+	confignode_builder_set_int(b, "height", t->Height);
 }
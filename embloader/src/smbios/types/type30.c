@@ -1,7 +1,7 @@
 #include "../smbios.h"
 
-void smbios_load_type30(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type30(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE30 *t = ptr.Type30;
-	embloader_smbios_set_config_string(ctx, ptr, m, "manufacturer_name", t->ManufacturerName);
-	confignode_path_set_int(m, "connections", t->Connections);
+	embloader_smbios_set_config_string(ctx, ptr, b, "manufacturer_name", t->ManufacturerName);
+	confignode_builder_set_int(b, "connections", t->Connections);
 }
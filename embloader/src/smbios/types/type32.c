@@ -1,6 +1,6 @@
 #include "../smbios.h"
 
-void smbios_load_type32(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type32(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE32 *t = ptr.Type32;
-	confignode_path_set_int(m, "boot_status", *(UINT8*)&t->BootStatus);
+	confignode_builder_set_int(b, "boot_status", *(UINT8*)&t->BootStatus);
 }
@@ -1,11 +1,11 @@
 #include "../smbios.h"
 
-void smbios_load_type36(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type36(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE36 *t = ptr.Type36;
-	confignode_path_set_int(m, "lower_threshold_non_critical", t->LowerThresholdNonCritical);
-	confignode_path_set_int(m, "upper_threshold_non_critical", t->UpperThresholdNonCritical);
-	confignode_path_set_int(m, "lower_threshold_critical", t->LowerThresholdCritical);
-	confignode_path_set_int(m, "upper_threshold_critical", t->UpperThresholdCritical);
-	confignode_path_set_int(m, "lower_threshold_non_recoverable", t->LowerThresholdNonRecoverable);
-	confignode_path_set_int(m, "upper_threshold_non_recoverable", t->UpperThresholdNonRecoverable);
+	confignode_builder_set_int(b, "lower_threshold_non_critical", t->LowerThresholdNonCritical);
+	confignode_builder_set_int(b, "upper_threshold_non_critical", t->UpperThresholdNonCritical);
+	confignode_builder_set_int(b, "lower_threshold_critical", t->LowerThresholdCritical);
+	confignode_builder_set_int(b, "upper_threshold_critical", t->UpperThresholdCritical);
+	confignode_builder_set_int(b, "lower_threshold_non_recoverable", t->LowerThresholdNonRecoverable);
+	confignode_builder_set_int(b, "upper_threshold_non_recoverable", t->UpperThresholdNonRecoverable);
 }
@@ -1,12 +1,12 @@
 #include "../smbios.h"
 
-void smbios_load_type38(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type38(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE38 *t = ptr.Type38;
-	confignode_path_set_int(m, "interface_type", t->InterfaceType);
-	confignode_path_set_int(m, "ipmi_specification_revision", t->IPMISpecificationRevision);
-	confignode_path_set_int(m, "i2c_slave_address", t->I2CSlaveAddress);
-	confignode_path_set_int(m, "nv_storage_device_address", t->NVStorageDeviceAddress);
-	confignode_path_set_int(m, "base_address", t->BaseAddress);
-	confignode_path_set_int(m, "base_address_modifier", t->BaseAddressModifier_InterruptInfo);
-	confignode_path_set_int(m, "interrupt_number", t->InterruptNumber);
+	confignode_builder_set_int(b, "interface_type", t->InterfaceType);
+	confignode_builder_set_int(b, "ipmi_specification_revision", t->IPMISpecificationRevision);
+	confignode_builder_set_int(b, "i2c_slave_address", t->I2CSlaveAddress);
+	confignode_builder_set_int(b, "nv_storage_device_address", t->NVStorageDeviceAddress);
+	confignode_builder_set_int(b, "base_address", t->BaseAddress);
+	confignode_builder_set_int(b, "base_address_modifier", t->BaseAddressModifier_InterruptInfo);
+	confignode_builder_set_int(b, "interrupt_number", t->InterruptNumber);
 }
@@ -359,80 +359,80 @@ static const char *processor_upgrade_to_string(int v) {
 	}
 }
 
-static void set_processor_feature_flags(confignode *m, PROCESSOR_FEATURE_FLAGS *f) {
-	confignode *fm = confignode_new_map();
-	confignode_path_map_set(m, "features", fm);
-	confignode_path_set_bool(fm, "fpu", f->ProcessorFpu);
-	confignode_path_set_bool(fm, "vme", f->ProcessorVme);
-	confignode_path_set_bool(fm, "de", f->ProcessorDe);
-	confignode_path_set_bool(fm, "pse", f->ProcessorPse);
-	confignode_path_set_bool(fm, "tsc", f->ProcessorTsc);
-	confignode_path_set_bool(fm, "msr", f->ProcessorMsr);
-	confignode_path_set_bool(fm, "pae", f->ProcessorPae);
-	confignode_path_set_bool(fm, "mce", f->ProcessorMce);
-	confignode_path_set_bool(fm, "cx8", f->ProcessorCx8);
-	confignode_path_set_bool(fm, "apic", f->ProcessorApic);
+static void set_processor_feature_flags(confignode_builder *b, PROCESSOR_FEATURE_FLAGS *f) {
+	confignode_builder_push_map(b, "features");
+	confignode_builder_set_bool(b, "fpu", f->ProcessorFpu);
+	confignode_builder_set_bool(b, "vme", f->ProcessorVme);
+	confignode_builder_set_bool(b, "de", f->ProcessorDe);
+	confignode_builder_set_bool(b, "pse", f->ProcessorPse);
+	confignode_builder_set_bool(b, "tsc", f->ProcessorTsc);
+	confignode_builder_set_bool(b, "msr", f->ProcessorMsr);
+	confignode_builder_set_bool(b, "pae", f->ProcessorPae);
+	confignode_builder_set_bool(b, "mce", f->ProcessorMce);
+	confignode_builder_set_bool(b, "cx8", f->ProcessorCx8);
+	confignode_builder_set_bool(b, "apic", f->ProcessorApic);
+	confignode_builder_pop(b);
 }
 
-static void set_processor_characteristics(confignode *m, PROCESSOR_CHARACTERISTIC_FLAGS *c) {
-	confignode *cm = confignode_new_map();
-	confignode_path_map_set(m, "characteristics", cm);
-	confignode_path_set_bool(cm, "unknown", c->ProcessorUnknown);
-	confignode_path_set_bool(cm, "64bit_capable", c->Processor64BitCapable);
-	confignode_path_set_bool(cm, "multi_core", c->ProcessorMultiCore);
-	confignode_path_set_bool(cm, "hardware_thread", c->ProcessorHardwareThread);
-	confignode_path_set_bool(cm, "execute_protection", c->ProcessorExecuteProtection);
-	confignode_path_set_bool(cm, "enhanced_virtualization", c->ProcessorEnhancedVirtualization);
-	confignode_path_set_bool(cm, "power_performance_ctrl", c->ProcessorPowerPerformanceCtrl);
-	confignode_path_set_bool(cm, "128bit_capable", c->Processor128BitCapable);
-	confignode_path_set_bool(cm, "arm64_soc_id", c->ProcessorArm64SocId);
+static void set_processor_characteristics(confignode_builder *b, PROCESSOR_CHARACTERISTIC_FLAGS *c) {
+	confignode_builder_push_map(b, "characteristics");
+	confignode_builder_set_bool(b, "unknown", c->ProcessorUnknown);
+	confignode_builder_set_bool(b, "64bit_capable", c->Processor64BitCapable);
+	confignode_builder_set_bool(b, "multi_core", c->ProcessorMultiCore);
+	confignode_builder_set_bool(b, "hardware_thread", c->ProcessorHardwareThread);
+	confignode_builder_set_bool(b, "execute_protection", c->ProcessorExecuteProtection);
+	confignode_builder_set_bool(b, "enhanced_virtualization", c->ProcessorEnhancedVirtualization);
+	confignode_builder_set_bool(b, "power_performance_ctrl", c->ProcessorPowerPerformanceCtrl);
+	confignode_builder_set_bool(b, "128bit_capable", c->Processor128BitCapable);
+	confignode_builder_set_bool(b, "arm64_soc_id", c->ProcessorArm64SocId);
+	confignode_builder_pop(b);
 }
 
-void smbios_load_type4(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type4(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE4 *t = ptr.Type4;
-	embloader_smbios_set_config_string(ctx, ptr, m, "socket", t->Socket);
-	embloader_smbios_set_config_string(ctx, ptr, m, "manufacturer", t->ProcessorManufacturer);
-	embloader_smbios_set_config_string(ctx, ptr, m, "version", t->ProcessorVersion);
-	embloader_smbios_set_config_string(ctx, ptr, m, "serial_number", t->SerialNumber);
-	embloader_smbios_set_config_string(ctx, ptr, m, "asset_tag", t->AssetTag);
-	embloader_smbios_set_config_string(ctx, ptr, m, "part_number", t->PartNumber);
-	confignode_path_set_string(m, "type", processor_type_to_string(t->ProcessorType));
+	embloader_smbios_set_config_string(ctx, ptr, b, "socket", t->Socket);
+	embloader_smbios_set_config_string(ctx, ptr, b, "manufacturer", t->ProcessorManufacturer);
+	embloader_smbios_set_config_string(ctx, ptr, b, "version", t->ProcessorVersion);
+	embloader_smbios_set_config_string(ctx, ptr, b, "serial_number", t->SerialNumber);
+	embloader_smbios_set_config_string(ctx, ptr, b, "asset_tag", t->AssetTag);
+	embloader_smbios_set_config_string(ctx, ptr, b, "part_number", t->PartNumber);
+	confignode_builder_set_string(b, "type", processor_type_to_string(t->ProcessorType));
 	if (t->ProcessorFamily == 0xfe && ctx->version >= SMBIOS_VER(2,6)) {
-		confignode_path_set_string(m, "family", processor_family2_to_string(t->ProcessorFamily2));
+		confignode_builder_set_string(b, "family", processor_family2_to_string(t->ProcessorFamily2));
 	} else {
-		confignode_path_set_string(m, "family", processor_family_to_string(t->ProcessorFamily));
+		confignode_builder_set_string(b, "family", processor_family_to_string(t->ProcessorFamily));
 	}
-	confignode_path_set_int(m, "external_clock", t->ExternalClock);
-	confignode_path_set_int(m, "max_speed", t->MaxSpeed);
-	confignode_path_set_int(m, "current_speed", t->CurrentSpeed);
-	confignode_path_set_int(m, "status", t->Status);
-	confignode_path_set_string(m, "processor_upgrade", processor_upgrade_to_string(t->ProcessorUpgrade));
-	confignode_path_set_int(m, "l1_cache_handle", t->L1CacheHandle);
-	confignode_path_set_int(m, "l2_cache_handle", t->L2CacheHandle);
-	confignode_path_set_int(m, "l3_cache_handle", t->L3CacheHandle);
+	confignode_builder_set_int(b, "external_clock", t->ExternalClock);
+	confignode_builder_set_int(b, "max_speed", t->MaxSpeed);
+	confignode_builder_set_int(b, "current_speed", t->CurrentSpeed);
+	confignode_builder_set_int(b, "status", t->Status);
+	confignode_builder_set_string(b, "processor_upgrade", processor_upgrade_to_string(t->ProcessorUpgrade));
+	confignode_builder_set_int(b, "l1_cache_handle", t->L1CacheHandle);
+	confignode_builder_set_int(b, "l2_cache_handle", t->L2CacheHandle);
+	confignode_builder_set_int(b, "l3_cache_handle", t->L3CacheHandle);
 	if (ctx->version >= SMBIOS_VER(2,5)) {
-		confignode_path_set_int(m, "core_count", t->CoreCount);
-		confignode_path_set_int(m, "enabled_core_count", t->EnabledCoreCount);
-		confignode_path_set_int(m, "thread_count", t->ThreadCount);
-		set_processor_characteristics(m, (PROCESSOR_CHARACTERISTIC_FLAGS*)&t->ProcessorCharacteristics);
+		confignode_builder_set_int(b, "core_count", t->CoreCount);
+		confignode_builder_set_int(b, "enabled_core_count", t->EnabledCoreCount);
+		confignode_builder_set_int(b, "thread_count", t->ThreadCount);
+		set_processor_characteristics(b, (PROCESSOR_CHARACTERISTIC_FLAGS*)&t->ProcessorCharacteristics);
 	}
-	set_processor_feature_flags(m, &t->ProcessorId.FeatureFlags);
+	set_processor_feature_flags(b, &t->ProcessorId.FeatureFlags);
 	if (ctx->version >= SMBIOS_VER(3,0)) {
 		int core_count = (t->CoreCount == 0xFF) ? t->CoreCount2 : t->CoreCount;
 		int enabled_core_count = (t->EnabledCoreCount == 0xFF) ? t->EnabledCoreCount2 : t->EnabledCoreCount;
 		int thread_count = (t->ThreadCount == 0xFF) ? t->ThreadCount2 : t->ThreadCount;
-		confignode_path_set_int(m, "core_count", core_count);
-		confignode_path_set_int(m, "enabled_core_count", enabled_core_count);
-		confignode_path_set_int(m, "thread_count", thread_count);
+		confignode_builder_set_int(b, "core_count", core_count);
+		confignode_builder_set_int(b, "enabled_core_count", enabled_core_count);
+		confignode_builder_set_int(b, "thread_count", thread_count);
 	} else {
-		confignode_path_set_int(m, "core_count", t->CoreCount);
-		confignode_path_set_int(m, "enabled_core_count", t->EnabledCoreCount);
-		confignode_path_set_int(m, "thread_count", t->ThreadCount);
+		confignode_builder_set_int(b, "core_count", t->CoreCount);
+		confignode_builder_set_int(b, "enabled_core_count", t->EnabledCoreCount);
+		confignode_builder_set_int(b, "thread_count", t->ThreadCount);
 	}
 	if (ctx->version >= SMBIOS_VER(3,6)) {
-		confignode_path_set_int(m, "thread_enabled", t->ThreadEnabled);
+		confignode_builder_set_int(b, "thread_enabled", t->ThreadEnabled);
 	}
 	if (ctx->version >= SMBIOS_VER(3,8)) {
-		embloader_smbios_set_config_string(ctx, ptr, m, "socket_type", t->SocketType);
+		embloader_smbios_set_config_string(ctx, ptr, b, "socket_type", t->SocketType);
 	}
 }
@@ -1,8 +1,10 @@
 #include "../smbios.h"
 
-void smbios_load_type44(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type44(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE44 *t = ptr.Type44;
-	confignode_path_set_int(m, "ref_handle", t->RefHandle);
-	confignode_path_set_int(m, "processor.length", t->ProcessorSpecificBlock.Length);
-	confignode_path_set_int(m, "processor.arch_type", t->ProcessorSpecificBlock.ProcessorArchType);
+	confignode_builder_set_int(b, "ref_handle", t->RefHandle);
+	confignode_builder_push_map(b, "processor");
+	confignode_builder_set_int(b, "length", t->ProcessorSpecificBlock.Length);
+	confignode_builder_set_int(b, "arch_type", t->ProcessorSpecificBlock.ProcessorArchType);
+	confignode_builder_pop(b);
 }
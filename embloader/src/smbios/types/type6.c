@@ -1,7 +1,7 @@
 #include "../smbios.h"
 
-void smbios_load_type6(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type6(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE6 *t = ptr.Type6;
-	confignode_path_set_int(m, "error_status", t->ErrorStatus);
-	confignode_path_set_int(m, "current_speed", t->CurrentSpeed);
+	confignode_builder_set_int(b, "error_status", t->ErrorStatus);
+	confignode_builder_set_int(b, "current_speed", t->CurrentSpeed);
 }
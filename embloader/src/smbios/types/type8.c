@@ -86,11 +86,11 @@ static const char *port_type_to_string(int v) {
 	}
 }
 
-void smbios_load_type8(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type8(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE8 *t = ptr.Type8;
-	embloader_smbios_set_config_string(ctx, ptr, m, "internal_reference_designator", t->InternalReferenceDesignator);
-	confignode_path_set_string(m, "internal_connector_type", port_connector_type_to_string(t->InternalConnectorType));
-	embloader_smbios_set_config_string(ctx, ptr, m, "external_reference_designator", t->ExternalReferenceDesignator);
-	confignode_path_set_string(m, "external_connector_type", port_connector_type_to_string(t->ExternalConnectorType));
-	confignode_path_set_string(m, "port_type", port_type_to_string(t->PortType));
+	embloader_smbios_set_config_string(ctx, ptr, b, "internal_reference_designator", t->InternalReferenceDesignator);
+	confignode_builder_set_string(b, "internal_connector_type", port_connector_type_to_string(t->InternalConnectorType));
+	embloader_smbios_set_config_string(ctx, ptr, b, "external_reference_designator", t->ExternalReferenceDesignator);
+	confignode_builder_set_string(b, "external_connector_type", port_connector_type_to_string(t->ExternalConnectorType));
+	confignode_builder_set_string(b, "port_type", port_type_to_string(t->PortType));
 }
@@ -76,51 +76,51 @@ static const char *slot_length_to_string(int v) {
 	}
 }
 
-void smbios_load_type9(embloader_smbios *ctx, confignode *m, SMBIOS_STRUCTURE_POINTER ptr) {
+void smbios_load_type9(embloader_smbios *ctx, confignode_builder *b, SMBIOS_STRUCTURE_POINTER ptr) {
 	SMBIOS_TABLE_TYPE9 *t = ptr.Type9;
-	embloader_smbios_set_config_string(ctx, ptr, m, "slot_designation", t->SlotDesignation);
-	confignode_path_set_string(m, "slot_type", slot_type_to_string(t->SlotType));
-	confignode_path_set_int(m, "slot_data_bus_width", t->SlotDataBusWidth);
-	confignode_path_set_string(m, "current_usage", slot_usage_to_string(t->CurrentUsage));
-	confignode_path_set_string(m, "slot_length", slot_length_to_string(t->SlotLength));
-	confignode_path_set_int(m, "slot_id", t->SlotID);
-	confignode *cm = confignode_new_map();
-	confignode_path_map_set(m, "characteristics", cm);
-	confignode_path_set_bool(cm, "characteristics_unknown", t->SlotCharacteristics1.CharacteristicsUnknown);
-	confignode_path_set_bool(cm, "provides_50_volts", t->SlotCharacteristics1.Provides50Volts);
-	confignode_path_set_bool(cm, "provides_33_volts", t->SlotCharacteristics1.Provides33Volts);
-	confignode_path_set_bool(cm, "shared_slot", t->SlotCharacteristics1.SharedSlot);
-	confignode_path_set_bool(cm, "pc_card_16_supported", t->SlotCharacteristics1.PcCard16Supported);
-	confignode_path_set_bool(cm, "cardbus_supported", t->SlotCharacteristics1.CardBusSupported);
-	confignode_path_set_bool(cm, "zoom_video_supported", t->SlotCharacteristics1.ZoomVideoSupported);
-	confignode_path_set_bool(cm, "modem_ring_resume_supported", t->SlotCharacteristics1.ModemRingResumeSupported);
-	confignode_path_set_bool(cm, "pme_signal_supported", t->SlotCharacteristics2.PmeSignalSupported);
-	confignode_path_set_bool(cm, "hot_plug_devices_supported", t->SlotCharacteristics2.HotPlugDevicesSupported);
-	confignode_path_set_bool(cm, "smbus_signal_supported", t->SlotCharacteristics2.SmbusSignalSupported);
-	confignode_path_set_bool(cm, "bifurcation_supported", t->SlotCharacteristics2.BifurcationSupported);
-	confignode_path_set_bool(cm, "async_surprise_removal", t->SlotCharacteristics2.AsyncSurpriseRemoval);
-	confignode_path_set_bool(cm, "flexbus_slot_cxl10_capable", t->SlotCharacteristics2.FlexbusSlotCxl10Capable);
-	confignode_path_set_bool(cm, "flexbus_slot_cxl20_capable", t->SlotCharacteristics2.FlexbusSlotCxl20Capable);
+	embloader_smbios_set_config_string(ctx, ptr, b, "slot_designation", t->SlotDesignation);
+	confignode_builder_set_string(b, "slot_type", slot_type_to_string(t->SlotType));
+	confignode_builder_set_int(b, "slot_data_bus_width", t->SlotDataBusWidth);
+	confignode_builder_set_string(b, "current_usage", slot_usage_to_string(t->CurrentUsage));
+	confignode_builder_set_string(b, "slot_length", slot_length_to_string(t->SlotLength));
+	confignode_builder_set_int(b, "slot_id", t->SlotID);
+	confignode_builder_push_map(b, "characteristics");
+	confignode_builder_set_bool(b, "characteristics_unknown", t->SlotCharacteristics1.CharacteristicsUnknown);
+	confignode_builder_set_bool(b, "provides_50_volts", t->SlotCharacteristics1.Provides50Volts);
+	confignode_builder_set_bool(b, "provides_33_volts", t->SlotCharacteristics1.Provides33Volts);
+	confignode_builder_set_bool(b, "shared_slot", t->SlotCharacteristics1.SharedSlot);
+	confignode_builder_set_bool(b, "pc_card_16_supported", t->SlotCharacteristics1.PcCard16Supported);
+	confignode_builder_set_bool(b, "cardbus_supported", t->SlotCharacteristics1.CardBusSupported);
+	confignode_builder_set_bool(b, "zoom_video_supported", t->SlotCharacteristics1.ZoomVideoSupported);
+	confignode_builder_set_bool(b, "modem_ring_resume_supported", t->SlotCharacteristics1.ModemRingResumeSupported);
+	confignode_builder_set_bool(b, "pme_signal_supported", t->SlotCharacteristics2.PmeSignalSupported);
+	confignode_builder_set_bool(b, "hot_plug_devices_supported", t->SlotCharacteristics2.HotPlugDevicesSupported);
+	confignode_builder_set_bool(b, "smbus_signal_supported", t->SlotCharacteristics2.SmbusSignalSupported);
+	confignode_builder_set_bool(b, "bifurcation_supported", t->SlotCharacteristics2.BifurcationSupported);
+	confignode_builder_set_bool(b, "async_surprise_removal", t->SlotCharacteristics2.AsyncSurpriseRemoval);
+	confignode_builder_set_bool(b, "flexbus_slot_cxl10_capable", t->SlotCharacteristics2.FlexbusSlotCxl10Capable);
+	confignode_builder_set_bool(b, "flexbus_slot_cxl20_capable", t->SlotCharacteristics2.FlexbusSlotCxl20Capable);
 	if (ctx->version >= SMBIOS_VER(3,7)) {
-		confignode_path_set_bool(cm, "flexbus_slot_cxl30_capable", t->SlotCharacteristics2.FlexbusSlotCxl30Capable);
+		confignode_builder_set_bool(b, "flexbus_slot_cxl30_capable", t->SlotCharacteristics2.FlexbusSlotCxl30Capable);
 	}
+	confignode_builder_pop(b);
 	if (ctx->version >= SMBIOS_VER(2,6)) {
-		confignode_path_set_int(m, "segment_group_num", t->SegmentGroupNum);
-		confignode_path_set_int(m, "bus_num", t->BusNum);
-		confignode_path_set_int(m, "dev_func_num", t->DevFuncNum);
+		confignode_builder_set_int(b, "segment_group_num", t->SegmentGroupNum);
+		confignode_builder_set_int(b, "bus_num", t->BusNum);
+		confignode_builder_set_int(b, "dev_func_num", t->DevFuncNum);
 	}
 	if (ctx->version >= SMBIOS_VER(3,2)) {
-		confignode_path_set_int(m, "data_bus_width", t->DataBusWidth);
-		confignode_path_set_int(m, "peer_grouping_count", t->PeerGroupingCount);
-		confignode *peer_array = confignode_new_array();
-		confignode_path_map_set(m, "peer_groups", peer_array);
+		confignode_builder_set_int(b, "data_bus_width", t->DataBusWidth);
+		confignode_builder_set_int(b, "peer_grouping_count", t->PeerGroupingCount);
+		confignode_builder_push_array(b, "peer_groups");
 		for (int i = 0; i < t->PeerGroupingCount && i < 1; ++i) {
-			confignode *peer = confignode_new_map();
-			confignode_array_append(peer_array, peer);
-			confignode_path_set_int(peer, "segment_group_num", t->PeerGroups[i].SegmentGroupNum);
-			confignode_path_set_int(peer, "bus_num", t->PeerGroups[i].BusNum);
-			confignode_path_set_int(peer, "dev_func_num", t->PeerGroups[i].DevFuncNum);
-			confignode_path_set_int(peer, "data_bus_width", t->PeerGroups[i].DataBusWidth);
+			confignode_builder_push_map(b, NULL);
+			confignode_builder_set_int(b, "segment_group_num", t->PeerGroups[i].SegmentGroupNum);
+			confignode_builder_set_int(b, "bus_num", t->PeerGroups[i].BusNum);
+			confignode_builder_set_int(b, "dev_func_num", t->PeerGroups[i].DevFuncNum);
+			confignode_builder_set_int(b, "data_bus_width", t->PeerGroups[i].DataBusWidth);
+			confignode_builder_pop(b);
 		}
+		confignode_builder_pop(b);
 	}
 }